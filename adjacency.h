@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_ADJACENCY_H
+#define Z7_ADJACENCY_H
+
+#include "cell_set.h"
+#include "library.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Z7 {
+
+// Graph of the neighbors within a set of cells, in compressed sparse row form. The vertices are the positions of the
+// cells in the set; those of the neighbors of vertex v are targets[offsets[v]] to targets[offsets[v + 1]], sorted.
+struct Z7Adjacency {
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> targets;
+};
+
+namespace detail {
+// First element of [first, last) not less than value, searching with growing steps from hint, forward or backward.
+inline const Z7Index *gallop_from(const Z7Index *first, const Z7Index *last, const Z7Index *hint,
+                                  const Z7Index &value) {
+    if (hint == last || hint->index < value.index)
+        return gallop(hint, last, value);
+    size_t step = 1;
+    const Z7Index *high = hint;
+    while (high - first > static_cast<ptrdiff_t>(step) && high[-static_cast<ptrdiff_t>(step)].index >= value.index) {
+        high -= step;
+        step *= 2;
+    }
+    return std::lower_bound(high - std::min<ptrdiff_t>(step, high - first), high, value, index_less);
+}
+
+// Neighbors in the set of its cells from first to last: the degree of each cell and the targets of all of them.
+inline void adjacency_slice(const Z7CellSet &cells, size_t first, size_t last, const Z7Configuration &config,
+                            std::vector<uint8_t> &degrees, std::vector<uint64_t> &targets) {
+    constexpr size_t block = 256;
+    std::array<std::array<Z7Index, 6>, block> around;
+    degrees.clear();
+    targets.clear();
+    for (size_t i = first; i < last; i += block) {
+        const size_t count = std::min(block, last - i);
+        neighbors_batch(cells.begin() + i, count, around.data(), config);
+        // Join the neighbors with the set as it is walked: most are a few cells away on the curve, so they are
+        // found with a short gallop from the cell itself.
+        for (size_t j = 0; j < count; j++) {
+            const Z7Index *cell = cells.begin() + i + j;
+            std::array<uint64_t, 6> found;
+            size_t degree = 0;
+            for (const auto &neighbor: around[j]) {
+                if (neighbor == Z7Index::invalid())
+                    continue;
+                const Z7Index *position = gallop_from(cells.begin(), cells.end(), cell, neighbor);
+                if (position == cells.end() || *position != neighbor)
+                    continue;
+                // Insertion sort, at most 6 of them.
+                const uint64_t target = static_cast<uint64_t>(position - cells.begin());
+                size_t k = degree++;
+                for (; k > 0 && found[k - 1] > target; k--)
+                    found[k] = found[k - 1];
+                found[k] = target;
+            }
+            degrees.push_back(static_cast<uint8_t>(degree));
+            targets.insert(targets.end(), found.begin(), found.begin() + degree);
+        }
+    }
+}
+} // namespace detail
+
+// Adjacency graph of a set of cells at the same resolution, with an edge both ways between each two that are
+// neighbors. Slices of the set are done by `threads` threads (0 for all cores) and then put together.
+inline Z7Adjacency build_adjacency(const Z7CellSet &cells, const Z7Configuration &config, unsigned threads = 0) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t slices = std::min<size_t>(threads, cells.size() / (1 << 14) + 1);
+    std::vector<std::vector<uint8_t>> degrees(slices);
+    std::vector<std::vector<uint64_t>> targets(slices);
+    std::vector<size_t> bounds;
+    for (size_t s = 0; s <= slices; s++)
+        bounds.push_back(cells.size() * s / slices);
+    const auto run = [&](auto &&work) {
+        if (slices == 1)
+            return work(0);
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < slices; s++)
+            workers.emplace_back(work, s);
+        for (auto &worker: workers)
+            worker.join();
+    };
+    run([&](size_t s) {
+        detail::adjacency_slice(cells, bounds[s], bounds[s + 1], config, degrees[s], targets[s]);
+    });
+
+    // Each slice then writes its part of the offsets and targets, after those of the previous slices.
+    std::vector<uint64_t> starts(slices + 1, 0);
+    for (size_t s = 0; s < slices; s++)
+        starts[s + 1] = starts[s] + targets[s].size();
+    Z7Adjacency res;
+    res.offsets.resize(cells.size() + 1);
+    res.targets.resize(starts[slices]);
+    res.offsets[cells.size()] = starts[slices];
+    run([&](size_t s) {
+        uint64_t offset = starts[s];
+        for (size_t i = 0; i < degrees[s].size(); i++) {
+            res.offsets[bounds[s] + i] = offset;
+            offset += degrees[s][i];
+        }
+        std::copy(targets[s].begin(), targets[s].end(), res.targets.begin() + starts[s]);
+    });
+    return res;
+}
+
+} // namespace Z7
+
+#endif // Z7_ADJACENCY_H
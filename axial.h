@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_AXIAL_H
+#define Z7_AXIAL_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <array>
+
+// Cells of a base zone as points of a hexagonal lattice. The vertex of the zone is the origin, and every digit adds a
+// step of its resolution in the direction of the digit. A step at one resolution is 1 / sqrt(7) of one at the
+// resolution above, rotated by 19.1 degrees clockwise at odd resolutions and counterclockwise at even ones, so the
+// lattices of two resolutions are not aligned: coordinates are in the lattice of the resolution of the cells.
+namespace Z7 {
+
+namespace detail {
+// A point of the hexagonal lattice of one resolution: a + b w, with w = e^(i pi / 3) (an Eisenstein integer).
+struct Hex {
+    int64_t a, b;
+};
+
+// The unit step of each digit: w^k, where digit 3^k (mod 7) is k rotations by 60 degrees from digit 1.
+inline constexpr std::array<Hex, 7> digit_steps{{{0, 0}, {1, 0}, {-1, 1}, {0, 1}, {0, -1}, {1, -1}, {-1, 0}}};
+
+// The digit of each residue mod 2 + w (a - 2b mod 7, as w == -2), used at odd resolutions. At even ones it is mod 3 - w
+// (a + 3b mod 7, as w == 3), where the residue is the digit.
+inline constexpr std::array<uint8_t, 7> odd_residue_digits{0, 1, 4, 5, 2, 3, 6};
+
+// A step at resolution r - 1 is m = 2 + w steps at r when r is odd, and m = 3 - w when it is even (19.1 degrees
+// one way, then back). Dividing by m is multiplying by its conjugate (the other one) over 7.
+constexpr Hex times_step(const Hex &z, int resolution) {
+    return resolution % 2 == 1 ? Hex{2 * z.a - z.b, z.a + 3 * z.b} : Hex{3 * z.a + z.b, 2 * z.b - z.a};
+}
+
+constexpr Hex over_step(const Hex &z, int resolution) {
+    return resolution % 2 == 1 ? Hex{(3 * z.a + z.b) / 7, (2 * z.b - z.a) / 7}
+                               : Hex{(2 * z.a - z.b) / 7, (z.a + 3 * z.b) / 7};
+}
+
+// Floor of x / 7.
+constexpr int64_t div_7(int64_t x) { return (x >= 0 ? x : x - 6) / 7; }
+
+// Two steps down make 7: (2 + w)(3 - w) == 7. So z = d1 + m d2 + 7 z' for the digits d1, d2 of two resolutions r and
+// r - 1 (as steps of r), and those are given by z mod 7. Indexed by the parity of r and (a mod 7) * 7 + b mod 7, with
+// what z' gets on top of z / 7 rounded down.
+struct Z7DigitPair {
+    uint8_t digits; // the digit of r - 1 << 3 | the digit of r
+    int8_t a, b;
+};
+
+inline constexpr std::array<std::array<Z7DigitPair, 49>, 2> digit_pairs = [] {
+    std::array<std::array<Z7DigitPair, 49>, 2> res{};
+    for (int parity = 0; parity < 2; parity++)
+        for (uint8_t d1 = 0; d1 < 7; d1++)
+            for (uint8_t d2 = 0; d2 < 7; d2++) {
+                const Hex m = times_step(digit_steps[d2], parity);
+                const Hex z{digit_steps[d1].a + m.a, digit_steps[d1].b + m.b};
+                const int64_t a = z.a - 7 * div_7(z.a), b = z.b - 7 * div_7(z.b);
+                res[parity][a * 7 + b] = {static_cast<uint8_t>(d2 << 3 | d1), static_cast<int8_t>((a - z.a) / 7),
+                                          static_cast<int8_t>((b - z.b) / 7)};
+            }
+    return res;
+}();
+
+// Digits of the lattice point z of the given resolution, relative to the vertex of the zone, two at a time. Returns
+// what is left at resolution 0, which is zero when the point is in the zone.
+constexpr Hex hex_to_digits(Hex z, int resolution, uint64_t &digits) {
+    int r = resolution;
+    for (; r > 1; r -= 2) {
+        const int64_t a = div_7(z.a), b = div_7(z.b);
+        const Z7DigitPair pair = digit_pairs[r % 2][(z.a - 7 * a) * 7 + z.b - 7 * b];
+        digits |= uint64_t{pair.digits} << Z7Index::resolution_shift(r);
+        z = {a + pair.a, b + pair.b};
+    }
+    if (r == 1) {
+        const int64_t residue = z.a - 2 * z.b - 7 * div_7(z.a - 2 * z.b);
+        const uint8_t digit = odd_residue_digits[residue];
+        digits |= uint64_t{digit} << Z7Index::resolution_shift(1);
+        z = over_step({z.a - digit_steps[digit].a, z.b - digit_steps[digit].b}, 1);
+    }
+    return z;
+}
+
+// Product of two lattice points, as w^2 == w - 1.
+constexpr Hex hex_times(const Hex &p, const Hex &q) {
+    return {p.a * q.a - p.b * q.b, p.a * q.b + p.b * q.a + p.b * q.b};
+}
+
+// Sign of the cross product of two lattice points (their basis is 60 degrees apart, so it is that of a1 b2 - b1 a2).
+constexpr int64_t hex_cross(const Hex &p, const Hex &q) { return p.a * q.b - p.b * q.a; }
+
+// Steps of the digits of two resolutions r - 1 and r, as steps of r: m d1 + d2. Indexed by the parity of r and
+// d1 * 7 + d2.
+inline constexpr std::array<std::array<Hex, 49>, 2> digit_pair_steps = [] {
+    std::array<std::array<Hex, 49>, 2> res{};
+    for (int parity = 0; parity < 2; parity++)
+        for (uint8_t d1 = 0; d1 < 7; d1++)
+            for (uint8_t d2 = 0; d2 < 7; d2++) {
+                const Hex m = times_step(digit_steps[d1], parity);
+                res[parity][d1 * 7 + d2] = {m.a + digit_steps[d2].a, m.b + digit_steps[d2].b};
+            }
+    return res;
+}();
+
+// Lattice point of a cell, as steps of its resolution, relative to the center of its ancestor at the anchor
+// resolution. Digits go two at a time, as two steps make 7.
+constexpr Hex lattice_offset(const Z7Index &cell, int anchor_resolution) {
+    const int resolution = cell.resolution();
+    Hex h{0, 0};
+    int r = anchor_resolution + 1;
+    if ((resolution - anchor_resolution) % 2 == 1) {
+        h = digit_steps[cell[r]];
+        r++;
+    }
+    for (; r < resolution; r += 2) {
+        const Hex s = digit_pair_steps[(r + 1) % 2][cell[r] * 7 + cell[r + 1]];
+        h = {7 * h.a + s.a, 7 * h.b + s.b};
+    }
+    return h;
+}
+
+// Lattice point h of the anchor resolution, as steps of a finer resolution.
+constexpr Hex refine(Hex h, int anchor_resolution, int resolution) {
+    int r = anchor_resolution + 1;
+    if ((resolution - anchor_resolution) % 2 == 1)
+        h = times_step(h, r++);
+    return {h.a * static_cast<int64_t>(powers_of_7[(resolution - r + 1) / 2]),
+            h.b * static_cast<int64_t>(powers_of_7[(resolution - r + 1) / 2])};
+}
+} // namespace detail
+
+// Axial coordinates on the hexagonal lattice of a resolution: q along the direction of digit 1 and r along that of
+// digit 3, 60 degrees counterclockwise of it. The neighbor of a cell in the direction of digit d is
+// detail::digit_steps[d] away.
+struct Z7Axial {
+    int64_t q, r;
+};
+
+constexpr bool operator==(const Z7Axial &a, const Z7Axial &b) { return a.q == b.q && a.r == b.r; }
+constexpr bool operator!=(const Z7Axial &a, const Z7Axial &b) { return !(a == b); }
+
+// Coordinates of a cell in the lattice of its resolution, relative to the center of its ancestor at the anchor
+// resolution (0 for the whole base zone).
+constexpr Z7Axial to_axial(const Z7Index &cell, int anchor_resolution) {
+    const detail::Hex h = detail::lattice_offset(cell, anchor_resolution);
+    return {h.a, h.b};
+}
+
+// Inverse of to_axial(): the cell at the given resolution at those coordinates relative to the center of the anchor.
+// They may be outside of the anchor, in any cell of its base zone. Returns Z7Index::invalid() for points in another
+// base zone or in the exclusion zone of this one.
+constexpr Z7Index from_axial(const Z7Index &anchor, const Z7Axial &axial, int resolution,
+                             const Z7Configuration &config) {
+    const int anchor_resolution = anchor.resolution();
+    const detail::Hex center = detail::refine(detail::lattice_offset(anchor, 0), anchor_resolution, resolution);
+    uint64_t digits = 0;
+    const detail::Hex rest = detail::hex_to_digits({center.a + axial.q, center.b + axial.r}, resolution, digits);
+    if (rest.a != 0 || rest.b != 0)
+        return Z7Index::invalid();
+    const uint8_t base = anchor.hierarchy.base;
+    const Z7Index cell{uint64_t{base} << 60 | digits | digits_below(resolution)};
+    return detail::in_exclusion_zone(cell, config.exclusion_zone[base]) ? Z7Index::invalid() : cell;
+}
+
+// Number of steps between two points of the lattice.
+constexpr int64_t axial_distance(const Z7Axial &a, const Z7Axial &b) {
+    const int64_t q = a.q - b.q, r = a.r - b.r, s = q + r;
+    return std::max({q < 0 ? -q : q, r < 0 ? -r : r, s < 0 ? -s : s});
+}
+
+} // namespace Z7
+
+#endif // Z7_AXIAL_H
@@ -3,7 +3,17 @@
 
 #include <benchmark/benchmark.h>
 
+#include <unordered_map>
+
+#include "../adjacency.h"
+#include "../axial.h"
+#include "../codec.h"
+#include "../flood_fill.h"
+#include "../geo.h"
+#include "../grid.h"
+#include "../hash_map.h"
 #include "../library.h"
+#include "../ray.h"
 
 static void Addition(benchmark::State& state, const Z7::Z7Index& a, const Z7::Z7Index& b)
 {
@@ -29,6 +39,350 @@ static void Neighbors(benchmark::State& state, const Z7::Z7Index& a)
     }
 }
 
+static void NeighborsCompileTimeConfiguration(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const auto neighbors = Z7::neighbors(a);
+        benchmark::DoNotOptimize(neighbors);
+    }
+}
+
+static void NeighborsBatch(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells;
+    for (auto cell = a; cells.size() < 1024 && cell != Z7::Z7Index::invalid(); ++cell)
+        cells.push_back(cell);
+    std::vector<std::array<Z7::Z7Index, 6>> neighbors(cells.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        Z7::neighbors_batch(cells.data(), cells.size(), neighbors.data(), {});
+        benchmark::DoNotOptimize(neighbors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+static void GridDisk(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    const int k = static_cast<int>(state.range(0));
+    std::vector<Z7::Z7Index> disk(Z7::grid_disk_size(k));
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const auto count = Z7::grid_disk(a, k, disk.data(), {});
+        benchmark::DoNotOptimize(count);
+    }
+}
+static void Parent(benchmark::State& state, const Z7::Z7Index& a)
+{
+    Z7::Z7Index cell = a;
+    for (auto _ : state)
+    {
+        // Roll up to resolution 9 and walk to the next cell, as a rollup over a range of cells does.
+        benchmark::DoNotOptimize(Z7::parent(cell, 9));
+        ++cell;
+    }
+}
+static void Str(benchmark::State& state, const Z7::Z7Index& a)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a.str());
+    }
+}
+static void ToChars(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells(1024);
+    Z7::Z7Index cell = a;
+    for (auto& c : cells)
+        c = cell++;
+    std::vector<char> text((Z7::max_chars + 1) * cells.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        char* end = Z7::to_chars(text.data(), text.data() + text.size(), cells.data(), cells.size());
+        benchmark::DoNotOptimize(end);
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+static void FromChars(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells(1024);
+    Z7::Z7Index cell = a;
+    for (auto& c : cells)
+        c = cell++;
+    std::vector<char> text((Z7::max_chars + 1) * cells.size());
+    const char* end = Z7::to_chars(text.data(), text.data() + text.size(), cells.data(), cells.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const auto result = Z7::from_chars(text.data(), end, cells.data(), cells.size());
+        benchmark::DoNotOptimize(result.count);
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+static void Decode(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells(1 << 16);
+    Z7::Z7Index cell = a;
+    for (auto& c : cells)
+        c = cell++;
+    const Z7::Z7CompressedColumn column(cells.data(), cells.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        column.decode(cells.data());
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.SetBytesProcessed(state.iterations() * cells.size() * sizeof(uint64_t));
+}
+template<typename Map>
+static void FindInMap(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells(1 << 20);
+    Z7::Z7Index cell = a;
+    for (auto& c : cells)
+        c = cell++;
+    Map map;
+    for (size_t i = 0; i < cells.size(); i += 2)
+        map[cells[i]] = i;
+    std::mt19937_64 generator(1);
+    std::vector<Z7::Z7Index> queries(1024);
+    for (auto& q : queries)
+        q = cells[generator() % cells.size()];
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        size_t found = 0;
+        for (const auto& q : queries)
+            found += map.find(q) != nullptr;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+struct UnorderedMap
+{
+    struct Hash
+    {
+        size_t operator()(const Z7::Z7Index& a) const { return std::hash<uint64_t>{}(a.index); }
+    };
+    std::unordered_map<Z7::Z7Index, size_t, Hash> map;
+    size_t& operator[](const Z7::Z7Index& a) { return map[a]; }
+    const size_t* find(const Z7::Z7Index& a) const
+    {
+        const auto it = map.find(a);
+        return it == map.end() ? nullptr : &it->second;
+    }
+};
+static void HashMapFind(benchmark::State& state, const Z7::Z7Index& a)
+{
+    FindInMap<Z7::Z7HashMap<size_t>>(state, a);
+}
+static void UnorderedMapFind(benchmark::State& state, const Z7::Z7Index& a)
+{
+    FindInMap<UnorderedMap>(state, a);
+}
+static void FromGeo(benchmark::State& state, int resolution)
+{
+    // Perform setup here
+    std::vector<double> lat, lon;
+    for (int i = 0; i < 1024; i++)
+    {
+        lat.push_back(-89.5 + 179.0 * ((i * 37) % 1024) / 1024);
+        lon.push_back(-179.5 + 359.0 * i / 1024);
+    }
+    std::vector<Z7::Z7Index> cells(lat.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        if (state.range(0) == 0)
+        {
+            for (size_t i = 0; i < lat.size(); i++)
+                cells[i] = Z7::from_geo(lat[i], lon[i], resolution);
+        }
+        else
+            Z7::from_geo(lat.data(), lon.data(), lat.size(), resolution, cells.data());
+        benchmark::DoNotOptimize(cells.data());
+    }
+    state.SetItemsProcessed(state.iterations() * lat.size());
+}
+static void ToGeo(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells;
+    for (auto cell = a; cells.size() < 1024 && cell != Z7::Z7Index::invalid(); ++cell)
+        cells.push_back(cell);
+    std::vector<double> lat(cells.size()), lon(cells.size());
+    // Cache up to the resolution of the cells when the argument is 1.
+    const Z7::Z7CentroidCache cache(state.range(0) == 0 ? 0 : a.resolution());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        cache.to_geo(cells.data(), cells.size(), lat.data(), lon.data());
+        benchmark::DoNotOptimize(lat.data());
+        benchmark::DoNotOptimize(lon.data());
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+static void Boundary(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells;
+    for (auto cell = a; cells.size() < 1024 && cell != Z7::Z7Index::invalid(); ++cell)
+        cells.push_back(cell);
+    std::vector<Z7::Z7Boundary> boundaries(cells.size());
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        Z7::boundary(cells.data(), cells.size(), boundaries.data());
+        benchmark::DoNotOptimize(boundaries.data());
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+static void AxialDistance(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    std::vector<Z7::Z7Index> cells;
+    for (auto cell = a; cells.size() < 1024 && cell != Z7::Z7Index::invalid(); ++cell)
+        cells.push_back(cell);
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const Z7::Z7Axial origin = Z7::to_axial(a, 0);
+        int64_t total = 0;
+        for (const auto& cell : cells)
+            total += Z7::axial_distance(origin, Z7::to_axial(cell, 0));
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+
+static void GridDistance(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    const int resolution = a.resolution();
+    const uint64_t count = Z7::ordinal_count(resolution);
+    std::vector<Z7::Z7Index> cells;
+    for (uint64_t i = 0; cells.size() < 1024; i++)
+    {
+        const Z7::Z7Index cell = Z7::from_ordinal(i * (count / 1024 + 1) % count, resolution);
+        if (!Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base]))
+            cells.push_back(cell);
+    }
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        int64_t total = 0;
+        for (const auto& cell : cells)
+            total += Z7::grid_distance(a, cell);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+
+static void FloodFill(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    const int resolution = a.resolution() + 6;
+    const auto inside = [&](const Z7::Z7Index& cell) { return Z7::parent(cell, a.resolution()) == a; };
+    size_t count = 0;
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const auto steps = Z7::flood_fill({Z7::center_child(a, resolution)}, inside, Z7::igeo7, state.range(0));
+        count = 0;
+        for (const auto& step : steps)
+            count += step.size();
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BuildAdjacency(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    const Z7::Z7CellSet cells = Z7::uncompact(Z7::Z7CellSet({a}), a.resolution() + 6, Z7::igeo7);
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        const Z7::Z7Adjacency graph = Z7::build_adjacency(cells, Z7::igeo7, state.range(0));
+        benchmark::DoNotOptimize(graph.targets.data());
+    }
+    state.SetItemsProcessed(state.iterations() * cells.size());
+}
+
+static void Ray(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    constexpr size_t steps = 1024;
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        if (state.range(0) == 0)
+        {
+            Z7::Z7Index cell = a;
+            for (size_t i = 0; i < steps; i++)
+                cell = Z7::neighbors(cell, Z7::igeo7)[2];
+            benchmark::DoNotOptimize(cell);
+        }
+        else if (state.range(0) == 1)
+        {
+            // Only the carry loop, with no check for leaving the zone.
+            Z7::Z7Index cell = a;
+            const size_t resolution = a.resolution();
+            for (size_t i = 0; i < steps; i++)
+                cell = Z7::neighbor<3>(cell, resolution).z7;
+            benchmark::DoNotOptimize(cell);
+        }
+        else
+        {
+            Z7::Z7RayIterator ray(a, 3);
+            for (size_t i = 0; i < steps; i++)
+                ++ray;
+            benchmark::DoNotOptimize(*ray);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * steps);
+}
+
+static void Range(benchmark::State& state, const Z7::Z7Index& a)
+{
+    // Perform setup here
+    const Z7::Z7Range range(a, a.resolution() + 7);
+
+    for (auto _ : state)
+    {
+        // This code gets timed
+        uint64_t total = 0;
+        for (const auto& cell : range)
+            total += cell.index;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * range.size());
+}
 
 // Register the function as a benchmark, multiple times to see consistency
 BENCHMARK_CAPTURE(Addition, 1101111111111111156435 + 1101111111111111142431, "1101111111111111156435"_Z7, "1101111111111111142431"_Z7);
@@ -42,5 +396,34 @@ BENCHMARK_CAPTURE(Neighbors, neighbors of 1101111111111111156435, "1101111111111
 BENCHMARK_CAPTURE(Neighbors, neighbors of 0800447777777777777777, "080044"_Z7);
 BENCHMARK_CAPTURE(Neighbors, neighbors of 1101111111111111156435, "1101111111111111156435"_Z7);
 BENCHMARK_CAPTURE(Neighbors, neighbors of 0800447777777777777777, "080044"_Z7);
+BENCHMARK_CAPTURE(Neighbors, neighbors of 0666666666666666666666 (crossing into pole 11), "0666666666666666666666"_Z7);
+
+BENCHMARK_CAPTURE(NeighborsCompileTimeConfiguration, neighbors of 1101111111111111156435, "1101111111111111156435"_Z7);
+BENCHMARK_CAPTURE(NeighborsCompileTimeConfiguration, neighbors of 0800447777777777777777, "080044"_Z7);
+
+BENCHMARK_CAPTURE(NeighborsBatch, 1024 neighbors from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(NeighborsBatch, 1024 neighbors from 1101111111111111156435, "1101111111111111156435"_Z7);
+BENCHMARK_CAPTURE(NeighborsBatch, 1024 neighbors from 0800447777777777777777, "080044"_Z7);
+
+BENCHMARK_CAPTURE(GridDisk, disk around 0823456012345601234560, "0823456012345601234560"_Z7)->Arg(1)->Arg(10);
+BENCHMARK_CAPTURE(GridDisk, disk around 0800000000000000000000, "0800000000000000000000"_Z7)->Arg(1)->Arg(10);
+
+BENCHMARK_CAPTURE(Parent, rollup from 082345601234560, "082345601234560"_Z7);
+BENCHMARK_CAPTURE(Str, str of 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(ToChars, 1024 cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(FromChars, 1024 cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(Decode, 65536 cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(HashMapFind, 1024 finds in 512k cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(UnorderedMapFind, 1024 finds in 512k cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(FromGeo, 1024 positions at resolution 10 (0 one by one / 1 batch), 10)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(FromGeo, 1024 positions at resolution 20 (0 one by one / 1 batch), 20)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(ToGeo, 1024 cells from 0823456 (0 computed / 1 cached), "0823456"_Z7)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(Boundary, 1024 cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(AxialDistance, 1024 cells from 0823456012345601234560, "0823456012345601234560"_Z7);
+BENCHMARK_CAPTURE(GridDistance, to 1024 cells in all zones from 0823456012, "0823456012"_Z7);
+BENCHMARK_CAPTURE(FloodFill, descendants at resolution 9 of 08234 (threads), "08234"_Z7)->Arg(1)->Arg(0);
+BENCHMARK_CAPTURE(BuildAdjacency, descendants at resolution 9 of 08234 (threads), "08234"_Z7)->Arg(1)->Arg(0);
+BENCHMARK_CAPTURE(Ray, 1024 steps towards 3 from 0823456012345601234560 (0 neighbors / 1 neighbor<3> / 2 iterator), "0823456012345601234560"_Z7)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_CAPTURE(Range, descendants at resolution 9 of 0812, "0812"_Z7);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_CELL_SET_H
+#define Z7_CELL_SET_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Z7 {
+
+namespace detail {
+// First element in [first, last) not less than value, searching from first with growing steps, so the cost is
+// logarithmic in the distance to the result rather than in the size of the range.
+inline const Z7Index *gallop(const Z7Index *first, const Z7Index *last, const Z7Index &value) {
+    size_t step = 1;
+    const Z7Index *low = first;
+    while (low + step < last && low[step].index < value.index) {
+        low += step;
+        step *= 2;
+    }
+    return std::lower_bound(low, std::min(low + step, last), value, index_less);
+}
+
+// Sort with `threads` threads (0 for all cores): each sorts a slice, then slices are merged pairwise in parallel.
+inline void parallel_sort(std::vector<Z7Index> &cells, unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t slices = std::min<size_t>(threads, cells.size() / (1 << 14) + 1);
+    if (slices <= 1) {
+        std::sort(cells.begin(), cells.end(), index_less);
+        return;
+    }
+    std::vector<size_t> bounds;
+    for (size_t s = 0; s <= slices; s++)
+        bounds.push_back(cells.size() * s / slices);
+    std::vector<std::thread> workers;
+    for (size_t s = 0; s < slices; s++) {
+        const auto first = cells.begin() + bounds[s];
+        const auto last = cells.begin() + bounds[s + 1];
+        workers.emplace_back([=] { std::sort(first, last, index_less); });
+    }
+    for (auto &worker: workers)
+        worker.join();
+    // Merge rounds alternate between cells and a scratch buffer (std::inplace_merge on Z7Index is miscompiled by GCC 12
+    // at -O2).
+    std::vector<Z7Index> scratch(cells.size());
+    auto *from = &cells, *to = &scratch;
+    for (size_t width = 1; width < slices; width *= 2) {
+        workers.clear();
+        for (size_t s = 0; s < slices; s += 2 * width) {
+            const size_t first = bounds[s];
+            const size_t middle = bounds[std::min(s + width, slices)];
+            const size_t last = bounds[std::min(s + 2 * width, slices)];
+            workers.emplace_back([=] {
+                std::merge(from->begin() + first, from->begin() + middle, from->begin() + middle,
+                           from->begin() + last, to->begin() + first, index_less);
+            });
+        }
+        for (auto &worker: workers)
+            worker.join();
+        std::swap(from, to);
+    }
+    if (from != &cells)
+        cells.swap(scratch);
+}
+} // namespace detail
+
+// A set of cells, kept as a sorted vector in the order of index (the space filling curve). Cells may be at any
+// resolution; a cell and its descendants are different elements.
+class Z7CellSet {
+public:
+    using const_iterator = const Z7Index *;
+
+    Z7CellSet() = default;
+
+    // Sorts the cells, using `threads` threads (0 for all cores) for large inputs, and drops duplicates.
+    explicit Z7CellSet(std::vector<Z7Index> cells, unsigned threads = 0) : cells(std::move(cells)) {
+        detail::parallel_sort(this->cells, threads);
+        this->cells.erase(std::unique(this->cells.begin(), this->cells.end()), this->cells.end());
+    }
+
+    // Take cells already sorted by index without duplicates.
+    static Z7CellSet from_sorted(std::vector<Z7Index> cells) {
+        Z7CellSet res;
+        res.cells = std::move(cells);
+        return res;
+    }
+
+    size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    const_iterator begin() const { return cells.data(); }
+    const_iterator end() const { return cells.data() + cells.size(); }
+    const std::vector<Z7Index> &data() const { return cells; }
+
+    bool contains(const Z7Index &cell) const {
+        const auto it = std::lower_bound(begin(), end(), cell, detail::index_less);
+        return it != end() && *it == cell;
+    }
+
+    // Cells of the set that are the given cell or its descendants, at any resolution. They are contiguous: from the
+    // descendant at resolution 20 with all new digits 0 to the cell itself (unused digits are 7, the largest).
+    std::pair<const_iterator, const_iterator> descendants_of(const Z7Index &cell) const {
+        const auto first = std::lower_bound(begin(), end(), center_child(cell, 20), detail::index_less);
+        const auto last = std::upper_bound(first, end(), cell, detail::index_less);
+        return {first, last};
+    }
+
+    friend bool operator==(const Z7CellSet &a, const Z7CellSet &b) { return a.cells == b.cells; }
+    friend bool operator!=(const Z7CellSet &a, const Z7CellSet &b) { return a.cells != b.cells; }
+
+private:
+    std::vector<Z7Index> cells;
+};
+
+// Set algebra by galloping merges: runs of one set between two elements of the other are skipped with a gallop instead
+// of one comparison per element, so small sets combine with large ones in about O(small * log(large / small)).
+
+inline Z7CellSet set_union(const Z7CellSet &a, const Z7CellSet &b) {
+    std::vector<Z7Index> res;
+    res.reserve(a.size() + b.size());
+    const Z7Index *i = a.begin(), *j = b.begin();
+    while (i != a.end() && j != b.end()) {
+        if (i->index < j->index) {
+            const auto run = detail::gallop(i, a.end(), *j);
+            res.insert(res.end(), i, run);
+            i = run;
+        } else if (j->index < i->index) {
+            const auto run = detail::gallop(j, b.end(), *i);
+            res.insert(res.end(), j, run);
+            j = run;
+        } else {
+            res.push_back(*i++);
+            j++;
+        }
+    }
+    res.insert(res.end(), i, a.end());
+    res.insert(res.end(), j, b.end());
+    return Z7CellSet::from_sorted(std::move(res));
+}
+
+inline Z7CellSet set_intersection(const Z7CellSet &a, const Z7CellSet &b) {
+    std::vector<Z7Index> res;
+    const Z7Index *i = a.begin(), *j = b.begin();
+    while (i != a.end() && j != b.end()) {
+        if (i->index < j->index) {
+            i = detail::gallop(i, a.end(), *j);
+        } else if (j->index < i->index) {
+            j = detail::gallop(j, b.end(), *i);
+        } else {
+            res.push_back(*i++);
+            j++;
+        }
+    }
+    return Z7CellSet::from_sorted(std::move(res));
+}
+
+// Cells of a that are not in b.
+inline Z7CellSet set_difference(const Z7CellSet &a, const Z7CellSet &b) {
+    std::vector<Z7Index> res;
+    const Z7Index *i = a.begin(), *j = b.begin();
+    while (i != a.end() && j != b.end()) {
+        if (i->index < j->index) {
+            const auto run = detail::gallop(i, a.end(), *j);
+            res.insert(res.end(), i, run);
+            i = run;
+        } else if (j->index < i->index) {
+            j = detail::gallop(j, b.end(), *i);
+        } else {
+            i++;
+            j++;
+        }
+    }
+    res.insert(res.end(), i, a.end());
+    return Z7CellSet::from_sorted(std::move(res));
+}
+
+namespace detail {
+// Number of children of a cell: 6 around a pentagon, where one falls in the exclusion zone, 7 otherwise.
+inline size_t children_count(const Z7Index &ref, const Z7Configuration &config) {
+    const int resolution = ref.resolution() + 1;
+    const uint8_t exclusion = config.exclusion_zone[ref.hierarchy.base];
+    const Z7Index child{center_child(ref, resolution).index |
+                        uint64_t{exclusion} << Z7Index::resolution_shift(resolution)};
+    return in_exclusion_zone(child, exclusion) ? 6 : 7;
+}
+} // namespace detail
+
+// Replace every complete group of siblings with their parent, recursively, in one pass over the sorted cells.
+inline Z7CellSet compact(const Z7CellSet &cells, const Z7Configuration &config) {
+    std::vector<Z7Index> res;
+    res.reserve(cells.size());
+    for (const auto &cell: cells) {
+        res.push_back(cell);
+        // The children of a cell come just before any cell after them in index order, so a complete group is at the
+        // end of res once its last child is added. Its parent is also after all of them.
+        for (int resolution = cell.resolution(); resolution > 0; resolution--) {
+            const Z7Index ancestor = parent(res.back(), resolution - 1);
+            const size_t count = detail::children_count(ancestor, config);
+            if (res.size() < count)
+                break;
+            const auto first = res.end() - count;
+            const uint8_t exclusion = config.exclusion_zone[ancestor.hierarchy.base];
+            const bool complete = std::all_of(first, res.end(), [&](const Z7Index &c) {
+                return c.resolution() == resolution && parent(c, resolution - 1) == ancestor &&
+                       (count == 7 || !detail::in_exclusion_zone(c, exclusion));
+            });
+            if (!complete)
+                break;
+            res.erase(first, res.end());
+            res.push_back(ancestor);
+        }
+    }
+    return Z7CellSet::from_sorted(std::move(res));
+}
+
+// Replace every cell coarser than the given resolution with its descendants at that resolution, skipping those in the
+// exclusion zones. Finer cells are kept. The set should not hold a cell and one of its descendants.
+inline Z7CellSet uncompact(const Z7CellSet &cells, int resolution, const Z7Configuration &config) {
+    std::vector<Z7Index> res;
+    for (const auto &cell: cells) {
+        const int cell_resolution = cell.resolution();
+        if (cell_resolution >= resolution) {
+            res.push_back(cell);
+            continue;
+        }
+        // Only descendants of the center of a pentagon can fall in the exclusion zone.
+        const uint8_t exclusion = config.exclusion_zone[cell.hierarchy.base];
+        const bool pentagon = cell_resolution == 0 || first_non_zero(cell) > static_cast<size_t>(cell_resolution);
+        const uint64_t count = detail::powers_of_7[resolution - cell_resolution];
+        Z7Index descendant = center_child(cell, resolution);
+        for (uint64_t n = 0; n < count; n++) {
+            if (!pentagon || !detail::in_exclusion_zone(descendant, exclusion))
+                res.push_back(descendant);
+            // Next descendant in index order: add one to the last digit, carrying into the previous ones.
+            for (int r = resolution; r > cell_resolution; r--) {
+                const uint64_t digit = *descendant[r] + 1;
+                descendant[r] = digit == 7 ? 0 : digit;
+                if (digit < 7)
+                    break;
+            }
+        }
+    }
+    return Z7CellSet::from_sorted(std::move(res));
+}
+
+} // namespace Z7
+
+#endif // Z7_CELL_SET_H
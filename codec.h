@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_CODEC_H
+#define Z7_CODEC_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Z7 {
+
+// A column of cells compressed in blocks of block_size. Each block stores its first index (frame of reference) and the
+// differences between consecutive indexes, bit packed at the width of the largest one. Cells sorted by index (the
+// order of operator++) give small differences and compress well; any order round trips.
+//
+// Everything lives in one vector of words, which can be written out as is and read back with from_words():
+//   [count] [blocks] then for each block [first index] [offset of its packed words << 8 | width], then the packed words
+//   of all blocks and two words of padding.
+class Z7CompressedColumn {
+public:
+    static constexpr size_t block_size = 128;
+
+    Z7CompressedColumn() : data{0, 0, 0, 0} {}
+
+    Z7CompressedColumn(const Z7Index *cells, size_t count) {
+        const size_t blocks = (count + block_size - 1) / block_size;
+        data.assign(2 + 2 * blocks, 0);
+        data[0] = count;
+        data[1] = blocks;
+        for (size_t b = 0; b < blocks; b++) {
+            const Z7Index *first = cells + b * block_size;
+            const size_t size = std::min(block_size, count - b * block_size);
+            uint64_t largest = 0;
+            for (size_t i = 1; i < size; i++)
+                largest |= first[i].index - first[i - 1].index;
+            const uint64_t width = Utils::bit_width(largest);
+            const uint64_t offset = data.size();
+            data[2 + 2 * b] = first[0].index;
+            data[3 + 2 * b] = offset << 8 | width;
+
+            // Delta i goes to bits [i * width, (i + 1) * width), the first one being zero.
+            data.resize(offset + (block_size * width + 63) / 64, 0);
+            for (size_t i = 1; i < size; i++) {
+                const uint64_t delta = first[i].index - first[i - 1].index;
+                const size_t bit = i * width;
+                data[offset + bit / 64] |= delta << (bit % 64);
+                if (bit % 64 + width > 64)
+                    data[offset + bit / 64 + 1] |= delta >> (64 - bit % 64);
+            }
+        }
+        // Decoding always reads the word after the one of a delta, also for blocks of width 0 with no words.
+        data.resize(data.size() + 2, 0);
+    }
+
+    // Load a column from the words of another one, as returned by words(). Throws std::invalid_argument if they are
+    // not a column: truncated, or with headers that point outside of them.
+    static Z7CompressedColumn from_words(const uint64_t *words, size_t count) {
+        if (count < 2)
+            throw std::invalid_argument("compressed column: no header");
+        const uint64_t blocks = words[1];
+        if (blocks != words[0] / block_size + (words[0] % block_size != 0) || blocks > (count - 2) / 2)
+            throw std::invalid_argument("compressed column: wrong number of blocks");
+        for (size_t b = 0; b < blocks; b++) {
+            const uint64_t header = words[3 + 2 * b];
+            const uint64_t offset = header >> 8, width = header & 0xFF;
+            // The packed words and the two read after them, the padding for the last block.
+            if (width > 64 || offset < 2 + 2 * blocks || offset > count || count - offset < 2 * width + 2)
+                throw std::invalid_argument("compressed column: block " + std::to_string(b) + " out of bounds");
+        }
+        Z7CompressedColumn res;
+        res.data.assign(words, words + count);
+        return res;
+    }
+
+    const std::vector<uint64_t> &words() const { return data; }
+
+    // Number of cells.
+    size_t size() const { return data[0]; }
+
+    size_t blocks() const { return data[1]; }
+
+    // First cell of a block, for binary searches over the blocks without decoding them.
+    Z7Index block_first(size_t block) const { return Z7Index{data[2 + 2 * block]}; }
+
+    // Decode a block into out, which must have room for block_size cells. Returns the number of cells in the block.
+    size_t decode_block(size_t block, Z7Index *out) const {
+        const size_t size = std::min(block_size, this->size() - block * block_size);
+        const uint64_t header = data[3 + 2 * block];
+        const uint64_t *packed = data.data() + (header >> 8);
+        const uint64_t width = header & 0xFF;
+        const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+
+        // Unpack all deltas first (no dependency between them), then add them up.
+        uint64_t deltas[block_size];
+        for (size_t i = 0; i < block_size; i++) {
+            const size_t bit = i * width;
+            const uint64_t shift = bit % 64;
+            // Split the shift of the next word in two so it is never 64.
+            deltas[i] = (packed[bit / 64] >> shift | (packed[bit / 64 + 1] << 1) << (63 - shift)) & mask;
+        }
+        uint64_t index = data[2 + 2 * block];
+        for (size_t i = 0; i < size; i++) {
+            index += deltas[i];
+            out[i] = Z7Index{index};
+        }
+        return size;
+    }
+
+    // Decode every cell into out, which must have room for size() of them.
+    void decode(Z7Index *out) const {
+        for (size_t b = 0; b < blocks(); b++)
+            out += decode_block(b, out);
+    }
+
+private:
+    std::vector<uint64_t> data;
+};
+
+} // namespace Z7
+
+#endif // Z7_CODEC_H
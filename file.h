@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_FILE_H
+#define Z7_FILE_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define Z7_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace Z7 {
+
+enum class Z7FileFormat {
+    text, // one cell per line, as written by to_chars()
+    binary, // the index of each cell as a little endian uint64_t
+};
+
+// Cells handed out by Z7FileReader::next().
+struct Z7Chunk {
+    const Z7Index *data;
+    size_t size;
+
+    const Z7Index *begin() const { return data; }
+    const Z7Index *end() const { return data + size; }
+};
+
+// Reads a file of cells by memory mapping it (or reading it whole where mmap is not available). Chunks of binary files
+// point straight into the mapping; text files are parsed chunk by chunk into a buffer reused by the next call.
+class Z7FileReader {
+public:
+    // Throws std::system_error if the file can not be opened or mapped. `sequential` tells the kernel to read ahead.
+    Z7FileReader(const std::string &path, Z7FileFormat format, bool sequential = true) : format(format) {
+#ifdef Z7_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (format == Z7FileFormat::binary && size % sizeof(uint64_t) != 0) {
+            ::close(fd);
+            throw std::system_error(std::make_error_code(std::errc::illegal_byte_sequence), path);
+        }
+        if (size > 0) {
+            void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+            data = static_cast<const char *>(map);
+            if (sequential)
+                ::madvise(map, size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+#else
+        (void) sequential;
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), path);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = contents.data();
+        size = contents.size();
+        if (format == Z7FileFormat::binary && size % sizeof(uint64_t) != 0)
+            throw std::system_error(std::make_error_code(std::errc::illegal_byte_sequence), path);
+#endif
+    }
+
+    Z7FileReader(const Z7FileReader &) = delete;
+    Z7FileReader &operator=(const Z7FileReader &) = delete;
+
+    ~Z7FileReader() {
+#ifdef Z7_MMAP
+        if (size > 0)
+            ::munmap(const_cast<char *>(data), size);
+#endif
+    }
+
+    // The next cells of the file, at most max_cells of them. Empty at the end of the file. Throws std::system_error
+    // with the parsing error on a malformed line.
+    Z7Chunk next(size_t max_cells = 1 << 16) {
+        if (format == Z7FileFormat::binary) {
+            const size_t count = std::min(max_cells, (size - offset) / sizeof(uint64_t));
+            const char *first = data + offset;
+            offset += count * sizeof(uint64_t);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            cells.resize(count);
+            for (size_t i = 0; i < count; i++)
+                cells[i] = Z7Index{__builtin_bswap64(reinterpret_cast<const uint64_t *>(first)[i])};
+            return {cells.data(), count};
+#else
+            static_assert(sizeof(Z7Index) == sizeof(uint64_t));
+            return {reinterpret_cast<const Z7Index *>(first), count};
+#endif
+        }
+
+        cells.resize(max_cells);
+        const auto result = from_chars(data + offset, data + size, cells.data(), max_cells);
+        if (result.ec != std::errc())
+            throw std::system_error(std::make_error_code(result.ec),
+                                    "line at byte " + std::to_string(result.ptr - data));
+        offset = result.ptr - data;
+        return {cells.data(), result.count};
+    }
+
+private:
+    Z7FileFormat format;
+    const char *data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    std::vector<Z7Index> cells;
+#ifndef Z7_MMAP
+    std::vector<char> contents;
+#endif
+};
+
+// Writes cells to a file in either format, through a buffer.
+class Z7FileWriter {
+public:
+    // Throws std::system_error if the file can not be created.
+    Z7FileWriter(const std::string &path, Z7FileFormat format) : format(format) {
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            throw std::system_error(errno, std::generic_category(), path);
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    }
+
+    Z7FileWriter(const Z7FileWriter &) = delete;
+    Z7FileWriter &operator=(const Z7FileWriter &) = delete;
+
+    ~Z7FileWriter() {
+        if (file != nullptr)
+            std::fclose(file);
+    }
+
+    // Throws std::system_error if the file can not be written, std::logic_error if it was closed.
+    void write(const Z7Index *cells, size_t count) {
+        if (file == nullptr)
+            throw std::logic_error("write to a closed Z7FileWriter");
+        constexpr size_t chunk = 4096;
+        buffer.resize(chunk * (max_chars + 1));
+        for (size_t i = 0; i < count; i += chunk) {
+            const size_t n = std::min(chunk, count - i);
+            char *end = buffer.data();
+            if (format == Z7FileFormat::text) {
+                end = to_chars(buffer.data(), buffer.data() + buffer.size(), cells + i, n);
+            } else {
+                for (size_t c = 0; c < n; c++)
+                    for (size_t b = 0; b < sizeof(uint64_t); b++)
+                        *end++ = static_cast<char>(cells[i + c].index >> (8 * b));
+            }
+            const size_t size = end - buffer.data();
+            if (std::fwrite(buffer.data(), 1, size, file) != size)
+                throw std::system_error(errno, std::generic_category(), "write");
+        }
+    }
+
+    // Flush and close the file; throws std::system_error on failure. Done by the destructor otherwise, ignoring errors.
+    // Closing it again does nothing.
+    void close() {
+        if (file == nullptr)
+            return;
+        const int error = std::fclose(file);
+        file = nullptr;
+        if (error != 0)
+            throw std::system_error(errno, std::generic_category(), "close");
+    }
+
+private:
+    Z7FileFormat format;
+    std::FILE *file = nullptr;
+    std::vector<char> buffer;
+};
+
+} // namespace Z7
+
+#endif // Z7_FILE_H
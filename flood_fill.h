@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_FLOOD_FILL_H
+#define Z7_FLOOD_FILL_H
+
+#include "cell_set.h"
+#include "library.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace Z7 {
+
+namespace detail {
+// One bit per ordinal of a resolution, set concurrently. Pages of 2^20 bits are allocated the first time one of their
+// bits is set, and so are the two levels of directories of 2^13 pages above them, so a region costs memory for the
+// part of the curve it covers at any resolution. The top directory has an entry per 2^46 ordinals: one up to
+// resolution 14, about 14000 at resolution 20.
+class Z7VisitedBits {
+public:
+    explicit Z7VisitedBits(int resolution) : top(((ordinal_count(resolution) - 1) >> top_shift) + 1) {}
+    Z7VisitedBits(const Z7VisitedBits &) = delete;
+    Z7VisitedBits &operator=(const Z7VisitedBits &) = delete;
+    ~Z7VisitedBits() {
+        for (auto &entry: top) {
+            DirectorySlot *middle = entry.load();
+            if (middle == nullptr)
+                continue;
+            for (size_t m = 0; m < directory_size; m++) {
+                PageSlot *pages = middle[m].load();
+                if (pages == nullptr)
+                    continue;
+                for (size_t p = 0; p < directory_size; p++)
+                    delete[] pages[p].load();
+                delete[] pages;
+            }
+            delete[] middle;
+        }
+    }
+
+    // Set the bit of an ordinal. Returns whether it was not set before.
+    bool insert(uint64_t ordinal) {
+        const uint64_t page = ordinal / page_bits;
+        DirectorySlot *middle = fetch(top[ordinal >> top_shift], directory_size);
+        PageSlot *pages = fetch(middle[page >> directory_bits & (directory_size - 1)], directory_size);
+        std::atomic<uint64_t> *words = fetch(pages[page & (directory_size - 1)], page_bits / 64);
+        const uint64_t bit = uint64_t{1} << ordinal % 64;
+        return (words[ordinal % page_bits / 64].fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+
+private:
+    using PageSlot = std::atomic<std::atomic<uint64_t> *>;
+    using DirectorySlot = std::atomic<PageSlot *>;
+
+    // The array a slot points to, allocated zeroed if it is still null.
+    template<typename T>
+    static T *fetch(std::atomic<T *> &slot, size_t size) {
+        T *res = slot.load(std::memory_order_acquire);
+        if (res == nullptr) {
+            T *fresh = new T[size]();
+            if (slot.compare_exchange_strong(res, fresh, std::memory_order_acq_rel))
+                res = fresh;
+            else
+                delete[] fresh; // another thread got there first, res is now its one
+        }
+        return res;
+    }
+
+    static constexpr uint64_t page_bits = uint64_t{1} << 20;
+    static constexpr int directory_bits = 13;
+    static constexpr size_t directory_size = size_t{1} << directory_bits;
+    static constexpr int top_shift = 20 + 2 * directory_bits;
+    std::vector<std::atomic<DirectorySlot *>> top;
+};
+
+// Expand from the cells of frontier not visited yet, one step at a time, calling visit with the cells reached at each
+// step sorted by index. The frontier is split in ranges of the curve between `threads` threads; each finds the
+// neighbors of its range in batches and keeps those that are inside and were not visited.
+template<typename Inside, typename Visit>
+void flood(std::vector<Z7Index> frontier, const Inside &inside, Z7VisitedBits &visited,
+           const Z7Configuration &config, unsigned threads, Visit &&visit) {
+    frontier.erase(std::remove_if(frontier.begin(), frontier.end(),
+                                  [&](const Z7Index &cell) { return !inside(cell) || !visited.insert(ordinal(cell)); }),
+                   frontier.end());
+    while (!frontier.empty()) {
+        parallel_sort(frontier, threads);
+        visit(frontier);
+        const size_t slices = std::min<size_t>(threads, frontier.size() / (1 << 12) + 1);
+        std::vector<std::vector<Z7Index>> next(slices);
+        const auto expand = [&](size_t s) {
+            constexpr size_t batch = 256;
+            std::array<std::array<Z7Index, 6>, batch> around;
+            const size_t first = frontier.size() * s / slices, last = frontier.size() * (s + 1) / slices;
+            for (size_t i = first; i < last; i += batch) {
+                const size_t count = std::min(batch, last - i);
+                neighbors_batch(frontier.data() + i, count, around.data(), config);
+                for (size_t j = 0; j < count; j++) {
+                    for (const auto &neighbor: around[j]) {
+                        if (neighbor != Z7Index::invalid() && inside(neighbor) && visited.insert(ordinal(neighbor)))
+                            next[s].push_back(neighbor);
+                    }
+                }
+            }
+        };
+        if (slices == 1) {
+            expand(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (size_t s = 0; s < slices; s++)
+                workers.emplace_back(expand, s);
+            for (auto &worker: workers)
+                worker.join();
+        }
+        frontier.clear();
+        for (const auto &part: next)
+            frontier.insert(frontier.end(), part.begin(), part.end());
+    }
+}
+
+inline unsigned flood_threads(unsigned threads) {
+    return threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+}
+} // namespace detail
+
+// Breadth first search from the seeds through the cells where inside(cell) is true, from neighbor to neighbor. Returns
+// the cells reached at each step (the seeds are step 0), sorted by index. Seeds must be at the same resolution, and
+// inside is called from `threads` threads at once (0 for all cores).
+template<typename Inside>
+std::vector<std::vector<Z7Index>> flood_fill(const std::vector<Z7Index> &seeds, const Inside &inside,
+                                             const Z7Configuration &config, unsigned threads = 0) {
+    std::vector<std::vector<Z7Index>> res;
+    if (seeds.empty())
+        return res;
+    detail::Z7VisitedBits visited(seeds.front().resolution());
+    detail::flood(seeds, inside, visited, config, detail::flood_threads(threads),
+                  [&](const std::vector<Z7Index> &step) { res.push_back(step); });
+    return res;
+}
+
+// Same as flood_fill() through the cells of a set, at the resolution of the seeds.
+inline std::vector<std::vector<Z7Index>> flood_fill(const std::vector<Z7Index> &seeds, const Z7CellSet &cells,
+                                                    const Z7Configuration &config, unsigned threads = 0) {
+    return flood_fill(seeds, [&](const Z7Index &cell) { return cells.contains(cell); }, config, threads);
+}
+
+// Label of the connected component of each cell of a set, in the order of the set: components are numbered from 0 in
+// the order of their first cell. Cells must be at the same resolution.
+inline std::vector<uint32_t> connected_components(const Z7CellSet &cells, const Z7Configuration &config,
+                                                  unsigned threads = 0) {
+    constexpr uint32_t unlabeled = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> res(cells.size(), unlabeled);
+    if (cells.empty())
+        return res;
+    detail::Z7VisitedBits visited(cells.begin()->resolution());
+    const auto inside = [&](const Z7Index &cell) { return cells.contains(cell); };
+    uint32_t label = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (res[i] != unlabeled)
+            continue;
+        detail::flood({cells.begin()[i]}, inside, visited, config, detail::flood_threads(threads),
+                      [&](const std::vector<Z7Index> &step) {
+                          // The step is sorted, so its cells are found going forward through the set.
+                          const Z7Index *position = cells.begin();
+                          for (const auto &cell: step) {
+                              position = detail::gallop(position, cells.end(), cell);
+                              res[position - cells.begin()] = label;
+                          }
+                      });
+        label++;
+    }
+    return res;
+}
+
+} // namespace Z7
+
+#endif // Z7_FLOOD_FILL_H
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_GBT_H
+#define Z7_GBT_H
+
+#include <array>
+#include <cstdint>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <utility>
+
+// https://en.wikipedia.org/wiki/Generalized_balanced_ternary#Addition_table_2
+
+namespace GBT::Addition {
+namespace CW {
+constexpr std::array<std::array<uint8_t, 7>, 7> addition_table_0{{{0, 1, 2, 3, 4, 5, 6},
+                                                                  {1, 4, 3, 6, 5, 2, 0},
+                                                                  {2, 3, 1, 4, 6, 0, 5},
+                                                                  {3, 6, 4, 5, 0, 1, 2},
+                                                                  {4, 5, 6, 0, 2, 3, 1},
+                                                                  {5, 2, 0, 1, 3, 6, 4},
+                                                                  {6, 0, 5, 2, 1, 4, 3}}};
+
+// TODO - Should be defined with size 8 for memory padding?
+constexpr std::array<std::array<uint8_t, 7>, 7> addition_table_1{{{0, 0, 0, 0, 0, 0, 0},
+                                                                  {0, 1, 0, 1, 0, 5, 0},
+                                                                  {0, 0, 2, 3, 0, 0, 2},
+                                                                  {0, 1, 3, 3, 0, 0, 0},
+                                                                  {0, 0, 0, 0, 4, 4, 6},
+                                                                  {0, 5, 0, 0, 4, 5, 0},
+                                                                  {0, 0, 2, 0, 6, 0, 6}}};
+
+constexpr std::pair<uint8_t, uint8_t> lookup(uint8_t a, uint8_t b) {
+    return {addition_table_1[a][b], addition_table_0[a][b]};
+}
+} // namespace CW
+
+namespace CCW {
+// constexpr std::array<std::array<uint8_t, 7>, 7> addition_table_0{{{0, 1, 2, 3, 4, 5, 6},
+//                                                                   {1, 2, 3, 4, 5, 6, 0},
+//                                                                   {2, 3, 4, 5, 6, 0, 1},
+//                                                                   {3, 4, 5, 6, 0, 1, 2},
+//                                                                   {4, 5, 6, 0, 1, 2, 3},
+//                                                                   {5, 6, 0, 1, 2, 3, 4},
+//                                                                   {6, 0, 1, 2, 3, 4, 5}}};
+
+// Instead of 2D array, we can just use mod 7 addition. So where we had addition_table_0[a][b],
+// we can instead do mod_7_table[a + b].
+constexpr std::array<uint8_t, 14> mod_7_table{0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6};
+
+// TODO - Should be defined with size 8 for memory padding?
+constexpr std::array<std::array<uint8_t, 7>, 7> addition_table_1{{{0, 0, 0, 0, 0, 0, 0},
+                                                                  {0, 1, 0, 3, 0, 1, 0},
+                                                                  {0, 0, 2, 2, 0, 0, 6},
+                                                                  {0, 3, 2, 3, 0, 0, 0},
+                                                                  {0, 0, 0, 0, 4, 5, 4},
+                                                                  {0, 1, 0, 0, 5, 5, 0},
+                                                                  {0, 0, 6, 0, 4, 0, 6}}};
+
+constexpr std::pair<uint8_t, uint8_t> lookup(uint8_t a, uint8_t b) {
+    return {addition_table_1[a][b], mod_7_table[a + b]};
+}
+} // namespace CCW
+
+// Word parallel (SWAR) GBT addition over the 20 packed 3-bit digits of a Z7Index.
+//
+// The sum digit of both tables is addition mod 7 once the digits are relabelled as residues: CCW digits already are,
+// and CW digits only need 1 <-> 2 and 5 <-> 6 swapped (i.e. swapping the two low bits). In residue space a digit pair
+// (A, B) carries iff B == A, B == 5A or A == 5B (mod 7); the carry is the raw label of `b` in the last case and of `a`
+// otherwise.
+//
+// The functions are templated on the word type W so the same code runs on a uint64_t or on a vector of them (see
+// Lanes below). W needs the bitwise operators, +, shifts by a constant and construction from a uint64_t.
+namespace SWAR {
+constexpr uint64_t lane_lsb = 0x0249249249249249ULL; // bit 0 of each digit
+constexpr uint64_t lane_msb = lane_lsb << 2; // bit 2 of each digit
+constexpr uint64_t digits_mask = (1ULL << 60) - 1;
+
+// Digits at odd resolutions (CW rotation).
+constexpr uint64_t odd_digits = 0b111000111000111000111000111000111000111000111000111000111000ULL;
+
+// Mask covering the digits of resolutions 1..resolution.
+constexpr uint64_t used_digits(int resolution) {
+    return resolution == 0 ? 0 : (digits_mask >> (3 * (20 - resolution))) << (3 * (20 - resolution));
+}
+
+constexpr bool any(uint64_t x) { return x != 0; }
+
+// Widen a lane LSB mask to the whole digit.
+template<typename W>
+constexpr W widen(W mask) {
+    return mask | mask << 1 | mask << 2;
+}
+
+// One bit (the lane LSB) per digit that is zero.
+template<typename W>
+constexpr W zero_lanes(W x) {
+    return ~(x | x >> 1 | x >> 2) & W(lane_lsb);
+}
+
+// Keep the used digits, treating any padding (7) inside them as zero.
+template<typename W>
+constexpr W zero_padding(W index, W used) {
+    const W d = index & used;
+    return d & ~widen(zero_lanes(d ^ W(digits_mask)));
+}
+
+// Swap the two low bits of every digit, mapping between CW labels and residues (it is its own inverse).
+template<typename W>
+constexpr W swap_labels(W x) {
+    return (x & W(lane_msb)) | ((x & W(lane_lsb)) << 1) | ((x >> 1) & W(lane_lsb));
+}
+
+// Convert raw digits to residues (and back).
+template<typename W>
+constexpr W to_residue(W x) {
+    return (x & ~W(odd_digits)) | (swap_labels(x) & W(odd_digits));
+}
+
+// Lane wise (a + b) mod 7.
+template<typename W>
+constexpr W add_mod_7(W a, W b) {
+    W s = ((a & ~W(lane_msb)) + (b & ~W(lane_msb))) ^ ((a ^ b) & W(lane_msb));
+    const W overflow = ((a & b) | ((a | b) & ~s)) & W(lane_msb);
+    s = s + (overflow >> 2); // 8 == 1 (mod 7)
+    return s & ~widen(zero_lanes(s ^ W(digits_mask)));
+}
+
+// Lane wise 2a mod 7 is a rotation of the 3 bits.
+template<typename W>
+constexpr W double_mod_7(W a) {
+    return ((a << 1) & W(lane_lsb * 6)) | ((a >> 2) & W(lane_lsb));
+}
+
+// Lane wise multiplication of raw digits by 5^k mod 7, i.e. k rotations by 60 degrees. As 5 == -2 (mod 7), that is
+// k % 3 doublings, which rotate the 3 bits, and a negation for odd k. Zero and padding (7) digits are left as is.
+template<typename W>
+constexpr W rotate_digits(W x, uint8_t k) {
+    for (int j = 0; j < k % 3; j++) {
+        x = double_mod_7(x);
+    }
+    if (k % 2 == 1) {
+        x = x ^ widen(~(zero_lanes(x) | zero_lanes(x ^ W(digits_mask))) & W(lane_lsb));
+    }
+    return x;
+}
+
+// Add two words of residues. Returns the sums and the carries moved one level up, as residues of the level they land
+// on. Carries out of level 1 land in the base bits.
+template<typename W>
+constexpr std::pair<W, W> add_lanes(W a, W b) {
+    // 5x == -2x, and negating a non zero residue flips its bits. Zero lanes never match a negated value.
+    const W carry_a = zero_lanes(a ^ b) | zero_lanes(b ^ double_mod_7(a) ^ W(digits_mask));
+    const W carry_b = zero_lanes(a ^ double_mod_7(b) ^ W(digits_mask));
+    // Converting to the raw label and then to the residue of the opposite rotation is a swap on every lane.
+    const W carries = ((a & widen(carry_a)) | (b & widen(carry_b))) << 3;
+    return {add_mod_7(a, b), swap_labels(carries) | (carries & ~W(digits_mask))};
+}
+
+// Add the carries into the sum until none are left. Lanes that carried out of level 1 get a non zero overflow.
+template<typename W>
+constexpr W add_residues(W sum, W carries, W &overflow) {
+    // Carries only ever move up one level per pass, so this runs at most 21 times.
+    while (any(carries)) {
+        const auto [r0, r1] = add_lanes(sum, carries);
+        sum = r0;
+        overflow = overflow | (r1 >> 60);
+        carries = r1 & W(digits_mask);
+    }
+    return sum;
+}
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+// A vector of uint64_t words for the functions above.
+struct Lanes {
+#if defined(__AVX512F__)
+    static constexpr size_t size = 8;
+    __m512i v;
+
+    explicit Lanes(__m512i v) : v(v) {}
+    explicit Lanes(uint64_t x) : v(_mm512_set1_epi64(static_cast<long long>(x))) {}
+    static Lanes load(const void *p) { return Lanes{_mm512_loadu_si512(p)}; }
+    void store(void *p) const { _mm512_storeu_si512(p, v); }
+
+    friend Lanes operator&(Lanes a, Lanes b) { return Lanes{_mm512_and_si512(a.v, b.v)}; }
+    friend Lanes operator|(Lanes a, Lanes b) { return Lanes{_mm512_or_si512(a.v, b.v)}; }
+    friend Lanes operator^(Lanes a, Lanes b) { return Lanes{_mm512_xor_si512(a.v, b.v)}; }
+    friend Lanes operator+(Lanes a, Lanes b) { return Lanes{_mm512_add_epi64(a.v, b.v)}; }
+    // The zero masked shifts: the plain ones pass GCC 12 an undefined vector to merge into, which -Wuninitialized flags
+    // wherever they are inlined. With every lane selected they are the same instruction.
+    friend Lanes operator<<(Lanes a, int n) { return Lanes{_mm512_maskz_slli_epi64(0xFF, a.v, n)}; }
+    friend Lanes operator>>(Lanes a, int n) { return Lanes{_mm512_maskz_srli_epi64(0xFF, a.v, n)}; }
+    friend bool any(Lanes a) { return _mm512_test_epi64_mask(a.v, a.v) != 0; }
+#else
+    static constexpr size_t size = 4;
+    __m256i v;
+
+    explicit Lanes(__m256i v) : v(v) {}
+    explicit Lanes(uint64_t x) : v(_mm256_set1_epi64x(static_cast<long long>(x))) {}
+    static Lanes load(const void *p) { return Lanes{_mm256_loadu_si256(static_cast<const __m256i *>(p))}; }
+    void store(void *p) const { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+
+    friend Lanes operator&(Lanes a, Lanes b) { return Lanes{_mm256_and_si256(a.v, b.v)}; }
+    friend Lanes operator|(Lanes a, Lanes b) { return Lanes{_mm256_or_si256(a.v, b.v)}; }
+    friend Lanes operator^(Lanes a, Lanes b) { return Lanes{_mm256_xor_si256(a.v, b.v)}; }
+    friend Lanes operator+(Lanes a, Lanes b) { return Lanes{_mm256_add_epi64(a.v, b.v)}; }
+    friend Lanes operator<<(Lanes a, int n) { return Lanes{_mm256_slli_epi64(a.v, n)}; }
+    friend Lanes operator>>(Lanes a, int n) { return Lanes{_mm256_srli_epi64(a.v, n)}; }
+    friend bool any(Lanes a) { return !_mm256_testz_si256(a.v, a.v); }
+#endif
+    friend Lanes operator~(Lanes a) { return a ^ Lanes{~0ULL}; }
+};
+#endif
+} // namespace SWAR
+
+// Add two digits at the given resolution, which decides the rotation. Returns {carry, sum}.
+constexpr std::pair<uint8_t, uint8_t> lookup(uint64_t resolution, uint8_t a, uint8_t b) {
+    return resolution % 2 == 0 ? CCW::lookup(a, b) : CW::lookup(a, b);
+}
+} // namespace GBT::Addition
+
+#endif // Z7_GBT_H
@@ -0,0 +1,554 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_GEO_H
+#define Z7_GEO_H
+
+#include "axial.h"
+#include "library.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Geographic coordinates of cells, on the ISEA (Icosahedral Snyder Equal Area) projection of IGEO7.
+//
+// Every face of the icosahedron is projected to a plane triangle with Snyder's equal area projection. The 12 base
+// zones are the vertices. Around each of them its 5 faces are unfolded into a plane, the frame of the zone, where the
+// cells are a hexagonal lattice: the vertex is the origin and every digit adds a step of its resolution. Steps at
+// resolution 0 are the edges to the neighbor vertices, in the directions of `neighbor_zones`, and every resolution is
+// 1 / sqrt(7) times smaller and rotated by +-19.1 degrees, alternating. The 5 faces leave a gap of 60 degrees in the
+// plane: the exclusion zone. Its sides are glued, and cells of the sector next to it that fall in the gap are on the
+// other side.
+namespace Z7 {
+
+namespace detail {
+inline constexpr double pi = 3.14159265358979323846;
+
+using Point = std::complex<double>;
+
+struct Vec3 {
+    double x, y, z;
+};
+
+inline double dot(const Vec3 &a, const Vec3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3 cross(const Vec3 &a, const Vec3 &b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+inline Vec3 scaled(const Vec3 &a, double s) { return {a.x * s, a.y * s, a.z * s}; }
+inline Vec3 normalized(const Vec3 &a) { return scaled(a, 1 / std::sqrt(dot(a, a))); }
+
+// Unit vector of a geographic position in degrees.
+inline Vec3 unit_vector(double lat, double lon) {
+    constexpr double radians = pi / 180;
+    const double cos_lat = std::cos(lat * radians);
+    return {cos_lat * std::cos(lon * radians), cos_lat * std::sin(lon * radians), std::sin(lat * radians)};
+}
+
+// Planar projection and frames of the zones, computed once from the configuration.
+struct Z7Geometry {
+    // Axes of the frame of the icosahedron in earth centered coordinates, with vertex 0 at the north pole and vertex 1
+    // at longitude 0. In geographic coordinates vertex 0 is at (58.282525588538995, 11.25) and vertex 1 is due north
+    // of it, over the pole.
+    std::array<Vec3, 3> axes;
+    std::array<Vec3, 12> vertices;
+    std::array<std::array<uint8_t, 3>, 20> faces;
+    std::array<Vec3, 20> centers;
+    // The same, coordinate by coordinate.
+    std::array<double, 20> center_x, center_y, center_z;
+    // Tangent directions at the center of each face: towards its first vertex and 90 degrees clockwise from it.
+    std::array<Vec3, 20> north, east;
+    // Projected vertices of each face, the center being the origin.
+    std::array<std::array<Point, 3>, 20> plane;
+    // From the plane of a face to the frame of the zone of each of its vertices: z = scale * w + offset. The unit of
+    // the frames is the length of an edge.
+    std::array<std::array<Point, 3>, 20> scale, offset;
+    // Whether the face is the one after the gap of that zone, counterclockwise: its points also have an image in the
+    // gap, rotated -60 degrees.
+    std::array<std::array<bool, 3>, 20> glued;
+    // Face of the sector of each zone from the direction of a digit to the one 60 degrees counterclockwise of it, or 20
+    // for the gap.
+    std::array<std::array<uint8_t, 7>, 12> sector_faces;
+    // Exclusion digit of each zone.
+    std::array<uint8_t, 12> exclusion;
+    // Step of resolution r in the frame of the zones, and an edge as a lattice point of resolution r.
+    std::array<Point, 21> steps, inverse_steps;
+    std::array<Hex, 21> edges;
+    // Constants of the projection: tan and cos of the angle g from the center of a face to a vertex, and the radius R'
+    // of the sphere with the area of the plane icosahedron.
+    double tan_g, cos_g, radius;
+};
+
+inline Point digit_direction(uint8_t digit) {
+    const Hex s = digit_steps[digit];
+    return {s.a + 0.5 * s.b, std::sqrt(3.0) / 2 * s.b};
+}
+
+inline Z7Geometry make_geometry(const Z7Configuration &config) {
+    Z7Geometry g{};
+    const Vec3 z = unit_vector(58.282525588538994675, 11.25);
+    const Vec3 x = normalized({-z.z * z.x, -z.z * z.y, 1 - z.z * z.z}); // the north pole, minus its part along z
+    g.axes = {x, cross(z, x), z};
+
+    // Vertices 1 to 5 westwards around vertex 0, 6 to 10 between them to the south, and 11 at the south pole.
+    const double lat = std::atan(0.5) * 180 / pi;
+    g.vertices[0] = {0, 0, 1};
+    for (int k = 0; k < 5; k++) {
+        g.vertices[1 + k] = unit_vector(lat, -72.0 * k);
+        g.vertices[6 + k] = unit_vector(-lat, -36 - 72.0 * k);
+    }
+    g.vertices[11] = {0, 0, -1};
+
+    // Faces are the triples of vertices at the length of an edge from each other.
+    size_t face = 0;
+    for (uint8_t a = 0; a < 12; a++)
+        for (uint8_t b = a + 1; b < 12; b++)
+            for (uint8_t c = b + 1; c < 12; c++) {
+                const auto &va = g.vertices[a], &vb = g.vertices[b], &vc = g.vertices[c];
+                if (dot(va, vb) > 0.4 && dot(vb, vc) > 0.4 && dot(va, vc) > 0.4) {
+                    g.faces[face] = {a, b, c};
+                    g.centers[face] = normalized({va.x + vb.x + vc.x, va.y + vb.y + vc.y, va.z + vb.z + vc.z});
+                    g.center_x[face] = g.centers[face].x;
+                    g.center_y[face] = g.centers[face].y;
+                    g.center_z[face] = g.centers[face].z;
+                    face++;
+                }
+            }
+
+    g.cos_g = dot(g.centers[0], g.vertices[g.faces[0][0]]);
+    g.tan_g = std::sqrt(1 - g.cos_g * g.cos_g) / g.cos_g;
+    // A plane face has area 4 pi / 20, and its vertices are at R' tan(g) from its center.
+    g.radius = std::sqrt(4 * pi / 20 / (3 * std::sqrt(3.0) / 4)) / g.tan_g;
+
+    for (size_t f = 0; f < 20; f++) {
+        const Vec3 &c = g.centers[f];
+        const Vec3 &a = g.vertices[g.faces[f][0]];
+        g.north[f] = normalized({a.x - dot(a, c) * c.x, a.y - dot(a, c) * c.y, a.z - dot(a, c) * c.z});
+        g.east[f] = cross(g.north[f], c);
+        for (size_t s = 0; s < 3; s++) {
+            const Vec3 &v = g.vertices[g.faces[f][s]];
+            const double azimuth = std::atan2(dot(v, g.east[f]), dot(v, g.north[f]));
+            g.plane[f][s] = g.radius * g.tan_g * Point{std::sin(azimuth), std::cos(azimuth)};
+        }
+    }
+
+    // The frame of each zone has the edge to the neighbor zone of each digit in the direction of that digit.
+    g.exclusion = config.exclusion_zone;
+    for (auto &faces: g.sector_faces)
+        faces.fill(20);
+    for (size_t f = 0; f < 20; f++) {
+        for (size_t s = 0; s < 3; s++) {
+            const uint8_t zone = g.faces[f][s];
+            const uint8_t exclusion = g.exclusion[zone];
+            // The face is between the digits of its other two vertices that are 60 degrees apart and not the gap (the
+            // exclusion digit and the one 60 degrees clockwise of it, both leading to the same zone).
+            for (uint8_t d1 = 1; d1 < 7; d1++) {
+                const uint8_t d2 = d1 * 3 % 7; // 60 degrees counterclockwise
+                for (const size_t s1: {(s + 1) % 3, (s + 2) % 3}) {
+                    const size_t s2 = 3 - s - s1;
+                    if (d2 == exclusion || config.neighbor_zones[zone][d1 - 1] != g.faces[f][s1] ||
+                        config.neighbor_zones[zone][d2 - 1] != g.faces[f][s2])
+                        continue;
+                    g.scale[f][s] = digit_direction(d1) / (g.plane[f][s1] - g.plane[f][s]);
+                    g.offset[f][s] = -g.scale[f][s] * g.plane[f][s];
+                    g.glued[f][s] = d1 == exclusion;
+                    g.sector_faces[zone][d1] = static_cast<uint8_t>(f);
+                }
+            }
+        }
+    }
+
+    g.steps[0] = 1;
+    g.inverse_steps[0] = 1;
+    g.edges[0] = {1, 0};
+    for (int r = 1; r <= 20; r++) {
+        const Hex m = times_step({1, 0}, r);
+        g.steps[r] = g.steps[r - 1] / (static_cast<double>(m.a) + static_cast<double>(m.b) * digit_direction(3));
+        g.edges[r] = times_step(g.edges[r - 1], r);
+        g.inverse_steps[r] = 1.0 / g.steps[r];
+    }
+    return g;
+}
+
+inline const Z7Geometry &geometry() {
+    static const Z7Geometry g = make_geometry(igeo7);
+    return g;
+}
+
+// Position of a unit vector in the frame of the icosahedron.
+inline Vec3 to_icosahedron(const Z7Geometry &g, const Vec3 &p) {
+    return {dot(p, g.axes[0]), dot(p, g.axes[1]), dot(p, g.axes[2])};
+}
+
+// Face with its center closest to p.
+inline size_t face_of(const Z7Geometry &g, const Vec3 &p) {
+    std::array<double, 20> d;
+    for (size_t f = 0; f < 20; f++)
+        d[f] = p.x * g.center_x[f] + p.y * g.center_y[f] + p.z * g.center_z[f];
+    size_t face = 0;
+    for (size_t f = 1; f < 20; f++)
+        face = d[f] > d[face] ? f : face;
+    return face;
+}
+
+// Snyder's equal area projection of p to the plane of face f (Snyder 1992, "An equal-area map projection for
+// polyhedral globes"). The face is split in 3 triangles from its center; the azimuth of p from the center is mapped
+// to the plane keeping the area of the spherical triangle it sweeps, and the distance scaled so areas are kept along
+// it too.
+inline Point isea_forward(const Z7Geometry &g, size_t f, const Vec3 &p) {
+    constexpr double third = 2 * pi / 3;
+    constexpr double big_g = pi / 5; // angle at a vertex between an edge and the center
+    constexpr double cot_30 = 1.7320508075688772;
+    constexpr double cos_thirds[3] = {1, -0.5, -0.5};
+    constexpr double sin_thirds[3] = {0, 0.8660254037844386, -0.8660254037844386};
+
+    // Azimuth from the center, clockwise from the first vertex, reduced to the third of the face from vertex k to the
+    // next. Its sine and cosine are rotations of the tangent components, only the area needs the angle.
+    const double north = dot(p, g.north[f]), east = dot(p, g.east[f]);
+    double azimuth = std::atan2(east, north);
+    if (azimuth < 0)
+        azimuth += 2 * pi;
+    const int k = std::min(2, static_cast<int>(azimuth / third));
+    azimuth -= k * third;
+    const double norm = std::sqrt(north * north + east * east);
+    const double cos_p = norm > 0 ? north / norm : 1, sin_p = norm > 0 ? east / norm : 0;
+    const double cos_az = cos_p * cos_thirds[k] + sin_p * sin_thirds[k];
+    const double sin_az = sin_p * cos_thirds[k] - cos_p * sin_thirds[k];
+
+    // Area of the spherical triangle from the center and vertex k to the edge along the azimuth, with h its angle at
+    // the edge, and the azimuth in the plane of the triangle with the same area.
+    const double h = std::acos(std::clamp(sin_az * std::sin(big_g) * g.cos_g - cos_az * std::cos(big_g), -1.0, 1.0));
+    const double area = azimuth + big_g + h - pi;
+    const double y = 2 * area, x = g.radius * g.radius * g.tan_g * g.tan_g - 2 * area * cot_30;
+    const double cos_a = x / std::sqrt(x * x + y * y), sin_a = y / std::sqrt(x * x + y * y);
+    // Distance to the edge along both azimuths: edge in the plane and q on the sphere, with sin(q / 2) from cos(q).
+    const double edge = g.radius * g.tan_g / (cos_a + sin_a * cot_30);
+    const double q_x = cos_az + sin_az * cot_30;
+    const double sin_q_2 = std::sqrt((1 - q_x / std::sqrt(q_x * q_x + g.tan_g * g.tan_g)) / 2);
+    // Scale the distance so areas are kept along the azimuth too. sin(z / 2) of the distance z from the center is half
+    // the chord.
+    const Vec3 &c = g.centers[f];
+    const Vec3 chord{p.x - c.x, p.y - c.y, p.z - c.z};
+    const double rho = edge * std::sqrt(dot(chord, chord)) / 2 / sin_q_2;
+    return rho * Point{sin_a * cos_thirds[k] + cos_a * sin_thirds[k], cos_a * cos_thirds[k] - sin_a * sin_thirds[k]};
+}
+
+// Nearest point of the lattice of the resolution to z, a point of the frame of a zone.
+inline Hex round_to_lattice(const Z7Geometry &g, const Point &z, int resolution) {
+    const Point t = z * g.inverse_steps[resolution];
+    const double b = t.imag() * 2 / std::sqrt(3.0);
+    const double a = t.real() - b / 2;
+    // Cube coordinates (a, b, -a - b): round each and fix the one that moved most.
+    double ra = std::round(a), rb = std::round(b);
+    const double rc = std::round(-a - b);
+    const double da = std::abs(ra - a), db = std::abs(rb - b), dc = std::abs(rc + a + b);
+    if (da > db && da > dc)
+        ra = -rb - rc;
+    else if (db > dc)
+        rb = -ra - rc;
+    return {static_cast<int64_t>(ra), static_cast<int64_t>(rb)};
+}
+
+// Whether the lattice point h of the given resolution is in the gap of the zone: strictly between the directions of
+// the exclusion digit and the one 60 degrees clockwise of it.
+inline bool in_gap(const Z7Geometry &g, uint8_t zone, const Hex &h, int resolution) {
+    const uint8_t exclusion = g.exclusion[zone];
+    const Hex before = hex_times(g.edges[resolution], digit_steps[exclusion * 5 % 7]);
+    const Hex after = hex_times(g.edges[resolution], digit_steps[exclusion]);
+    return hex_cross(before, h) > 0 && hex_cross(h, after) > 0;
+}
+
+// The cell at lattice point h of the frame of a zone, or invalid if it belongs to another zone. Points in the gap are
+// those of the face before it, seen across its side: the cells there are on the face after the gap. Points of the
+// exclusion sector are the cells of the sector next to them across the gap: rotated 60 degrees clockwise (times 5)
+// outside of the gap, or counterclockwise (times 3) inside.
+inline Z7Index lattice_cell(const Z7Geometry &g, uint8_t zone, const Hex &h, int resolution) {
+    uint64_t digits = 0;
+    const Hex rest = hex_to_digits(h, resolution, digits);
+    if (rest.a != 0 || rest.b != 0)
+        return Z7Index::invalid();
+    const Z7Index cell{uint64_t{zone} << 60 | digits | digits_below(resolution)};
+    if (!in_exclusion_zone(cell, g.exclusion[zone]))
+        return cell;
+    return rotate(cell, in_gap(g, zone, h, resolution) ? 5 : 1);
+}
+// The cell at the given resolution of the point w of the plane of face f. Tries the zones of the vertices of the face
+// from the closest: the nearest lattice point is the cell, unless it is in another zone.
+inline Z7Index cell_in_face(const Z7Geometry &g, size_t f, const Point &w, int resolution) {
+    std::array<double, 3> distances;
+    for (size_t s = 0; s < 3; s++)
+        distances[s] = std::norm(w - g.plane[f][s]);
+    const size_t first = distances[0] < distances[1] ? (distances[0] < distances[2] ? 0 : 2)
+                                                     : (distances[1] < distances[2] ? 1 : 2);
+    const size_t second = (first + 1) % 3, third = (first + 2) % 3;
+    const bool in_order = distances[second] < distances[third];
+    for (const size_t s: {first, in_order ? second : third, in_order ? third : second}) {
+        const uint8_t zone = g.faces[f][s];
+        const Point z = g.scale[f][s] * w + g.offset[f][s];
+        Hex h = round_to_lattice(g, z, resolution);
+        // The gap seen from the face after it shows the face before it. Points of this face across that side are
+        // found rotated -60 degrees into the gap, as seen from the face before it.
+        if (g.glued[f][s] && in_gap(g, zone, h, resolution))
+            h = round_to_lattice(g, z * Point{0.5, -std::sqrt(3.0) / 2}, resolution);
+        const Z7Index cell = lattice_cell(g, zone, h, resolution);
+        if (cell != Z7Index::invalid())
+            return cell;
+    }
+    return Z7Index::invalid();
+}
+
+// Inverse of isea_forward(): the unit vector of the point w of the plane of face f.
+inline Vec3 isea_inverse(const Z7Geometry &g, size_t f, const Point &w) {
+    constexpr double third = 2 * pi / 3;
+    constexpr double big_g = pi / 5;
+    constexpr double cot_30 = 1.7320508075688772;
+
+    // Azimuth in the plane, clockwise from the first vertex, reduced to the third of the face from vertex k.
+    double a = std::atan2(w.real(), w.imag());
+    if (a < 0)
+        a += 2 * pi;
+    const int k = std::min(2, static_cast<int>(a / third));
+    a -= k * third;
+    const double cos_a = std::cos(a), sin_a = std::sin(a);
+
+    // Area of the plane triangle from the center and vertex k to the edge along a, and the azimuth on the sphere with
+    // the same area: with A = area + pi - G, the angle at the edge is h = A - azimuth, and the spherical law of cosines
+    // for h gives tan(azimuth) = (cos A + cos G) / (sin G cos g - sin A).
+    const double area = sin_a * g.radius * g.radius * g.tan_g * g.tan_g / (2 * (cos_a + sin_a * cot_30));
+    const double big_a = area + pi - big_g;
+    // The tangent gives it up to half a turn, and it is in [0, 2 pi / 3].
+    double azimuth = std::atan2(std::cos(big_a) + std::cos(big_g), std::sin(big_g) * g.cos_g - std::sin(big_a));
+    if (azimuth < -pi / 4)
+        azimuth += pi;
+    else if (azimuth >= 3 * pi / 4)
+        azimuth -= pi;
+
+    // Distance from the center as in isea_forward(), solved for the half chord sin(z / 2).
+    const double edge = g.radius * g.tan_g / (cos_a + sin_a * cot_30);
+    const double q_x = std::cos(azimuth) + std::sin(azimuth) * cot_30;
+    const double sin_q_2 = std::sqrt((1 - q_x / std::sqrt(q_x * q_x + g.tan_g * g.tan_g)) / 2);
+    const double z = 2 * std::asin(std::min(1.0, std::abs(w) * sin_q_2 / edge));
+
+    const double total = azimuth + k * third;
+    const Vec3 &c = g.centers[f], &n = g.north[f], &e = g.east[f];
+    const double cos_t = std::cos(total), sin_t = std::sin(total), cos_z = std::cos(z), sin_z = std::sin(z);
+    return {c.x * cos_z + (n.x * cos_t + e.x * sin_t) * sin_z, c.y * cos_z + (n.y * cos_t + e.y * sin_t) * sin_z,
+            c.z * cos_z + (n.z * cos_t + e.z * sin_t) * sin_z};
+}
+
+inline Point lattice_point(const Z7Geometry &g, const Hex &h, int resolution) {
+    return g.steps[resolution] * Point{h.a + 0.5 * h.b, std::sqrt(3.0) / 2 * h.b};
+}
+
+// Digit whose direction starts the sector of the frame of a zone containing z, counterclockwise.
+inline uint8_t sector_of(const Point &z) {
+    constexpr uint8_t digits[6] = {1, 3, 2, 6, 4, 5};
+    double angle = std::atan2(z.imag(), z.real());
+    if (angle < 0)
+        angle += 2 * pi;
+    return digits[std::min(5, static_cast<int>(angle / (pi / 3)))];
+}
+
+// Unit vector of the point z of the frame of a zone, not in the gap.
+inline Vec3 zone_to_sphere(const Z7Geometry &g, uint8_t zone, const Point &z) {
+    uint8_t sector = sector_of(z);
+    if (g.sector_faces[zone][sector] == 20) {
+        // On a side of the gap, up to rounding: the sector before it or the one after it, whichever side is closer.
+        const uint8_t exclusion = g.exclusion[zone];
+        const Point u = z / std::abs(z);
+        sector = std::norm(u - digit_direction(sector)) < std::norm(u - digit_direction(exclusion)) ? sector * 5 % 7
+                                                                                                    : exclusion;
+    }
+    const size_t f = g.sector_faces[zone][sector];
+    const size_t s = static_cast<size_t>(std::find(g.faces[f].begin(), g.faces[f].end(), zone) - g.faces[f].begin());
+    return isea_inverse(g, f, (z - g.offset[f][s]) / g.scale[f][s]);
+}
+
+// Geographic position in degrees of a unit vector in the frame of the icosahedron.
+inline std::pair<double, double> to_degrees(const Z7Geometry &g, const Vec3 &p) {
+    const Vec3 e{g.axes[0].x * p.x + g.axes[1].x * p.y + g.axes[2].x * p.z,
+                 g.axes[0].y * p.x + g.axes[1].y * p.y + g.axes[2].y * p.z,
+                 g.axes[0].z * p.x + g.axes[1].z * p.y + g.axes[2].z * p.z};
+    return {std::asin(std::clamp(e.z, -1.0, 1.0)) * 180 / pi, std::atan2(e.y, e.x) * 180 / pi};
+}
+
+// Center of a cell in the frame of its zone. Cells in the gap are on the face after it: their center is turned 60
+// degrees counterclockwise onto it.
+inline Point cell_center(const Z7Geometry &g, const Z7Index &cell, int resolution) {
+    const Hex h = lattice_offset(cell, 0);
+    const Point z = lattice_point(g, h, resolution);
+    return in_gap(g, cell.hierarchy.base, h, resolution) ? z * Point{0.5, std::sqrt(3.0) / 2} : z;
+}
+} // namespace detail
+
+// A geographic position, in degrees.
+struct Z7GeoPoint {
+    double lat, lon;
+};
+
+// Vertices of the boundary of a cell, counterclockwise seen from above. Pentagons have 5.
+struct Z7Boundary {
+    std::array<Z7GeoPoint, 6> vertices;
+    size_t count;
+};
+
+// The cell at the given resolution containing a geographic position, in degrees.
+inline Z7Index from_geo(double lat, double lon, int resolution) {
+    const auto &g = detail::geometry();
+    const detail::Vec3 p = detail::to_icosahedron(g, detail::unit_vector(lat, lon));
+    const size_t f = detail::face_of(g, p);
+    return detail::cell_in_face(g, f, detail::isea_forward(g, f, p), resolution);
+}
+
+// Same as from_geo() for `count` positions, writing the cell of (lat[i], lon[i]) to out[i]. Positions go through
+// each step in blocks, as arrays of coordinates: the rotation to the frame of the icosahedron and the search of the
+// faces are straight loops over the block, that the compiler turns into vector instructions.
+inline void from_geo(const double *lat, const double *lon, size_t count, int resolution, Z7Index *out) {
+    constexpr size_t block = 64;
+    const auto &g = detail::geometry();
+    for (size_t first = 0; first < count; first += block) {
+        const size_t n = std::min(block, count - first);
+        double x[block], y[block], z[block], best[block];
+        uint8_t face[block];
+        for (size_t i = 0; i < n; i++) {
+            const detail::Vec3 p = detail::unit_vector(lat[first + i], lon[first + i]);
+            x[i] = p.x;
+            y[i] = p.y;
+            z[i] = p.z;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const double px = x[i], py = y[i], pz = z[i];
+            x[i] = px * g.axes[0].x + py * g.axes[0].y + pz * g.axes[0].z;
+            y[i] = px * g.axes[1].x + py * g.axes[1].y + pz * g.axes[1].z;
+            z[i] = px * g.axes[2].x + py * g.axes[2].y + pz * g.axes[2].z;
+            best[i] = -2;
+            face[i] = 0;
+        }
+        for (uint8_t f = 0; f < 20; f++) {
+            for (size_t i = 0; i < n; i++) {
+                const double d = x[i] * g.center_x[f] + y[i] * g.center_y[f] + z[i] * g.center_z[f];
+                face[i] = d > best[i] ? f : face[i];
+                best[i] = d > best[i] ? d : best[i];
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            const detail::Point w = detail::isea_forward(g, face[i], {x[i], y[i], z[i]});
+            out[first + i] = detail::cell_in_face(g, face[i], w, resolution);
+        }
+    }
+}
+
+// Center of a cell: the point of the lattice of its resolution, projected back to the sphere.
+inline Z7GeoPoint to_geo(const Z7Index &cell) {
+    const auto &g = detail::geometry();
+    const detail::Point z = detail::cell_center(g, cell, cell.resolution());
+    const auto [lat, lon] = detail::to_degrees(g, detail::zone_to_sphere(g, cell.hierarchy.base, z));
+    return {lat, lon};
+}
+
+// Same as to_geo() for `count` cells, writing the center of cells[i] to (lat[i], lon[i]).
+inline void to_geo(const Z7Index *cells, size_t count, double *lat, double *lon) {
+    for (size_t i = 0; i < count; i++) {
+        const Z7GeoPoint p = to_geo(cells[i]);
+        lat[i] = p.lat;
+        lon[i] = p.lon;
+    }
+}
+
+// Boundary of a cell: the hexagon of the lattice around its center, with vertices at the centers of the triangles of
+// lattice points. Vertices falling in the gap are moved across it, to the face on the other side of the seam of the
+// sector of the center; the one of a pentagon (the cell at the vertex of the zone) is dropped.
+inline Z7Boundary boundary(const Z7Index &cell) {
+    constexpr uint8_t digits[6] = {1, 3, 2, 6, 4, 5}; // counterclockwise
+    const auto &g = detail::geometry();
+    const int resolution = cell.resolution();
+    const uint8_t zone = cell.hierarchy.base;
+    const uint8_t exclusion = g.exclusion[zone];
+    const detail::Point center = detail::cell_center(g, cell, resolution);
+    const bool pentagon = center == detail::Point{};
+    // Seen from the face after the gap, the gap shows the face before it, and the other way around.
+    const double turn = detail::sector_of(center) == exclusion ? -1 : 1;
+    const detail::Point across{0.5, turn * std::sqrt(3.0) / 2};
+    Z7Boundary res{};
+    for (size_t k = 0; k < 6; k++) {
+        const detail::Point corner = detail::digit_direction(digits[k]) + detail::digit_direction(digits[(k + 1) % 6]);
+        detail::Point z = center + g.steps[resolution] * corner / 3.0;
+        if (detail::sector_of(z) == exclusion * 5 % 7) {
+            if (pentagon)
+                continue;
+            z *= across;
+        }
+        const auto [lat, lon] = detail::to_degrees(g, detail::zone_to_sphere(g, zone, z));
+        res.vertices[res.count++] = {lat, lon};
+    }
+    return res;
+}
+
+// Same as boundary() for `count` cells, writing the boundary of cells[i] to out[i].
+inline void boundary(const Z7Index *cells, size_t count, Z7Boundary *out) {
+    for (size_t i = 0; i < count; i++)
+        out[i] = boundary(cells[i]);
+}
+
+// Centers of every cell up to a resolution, computed once (in parallel, with `threads` threads or 0 for all cores)
+// and then looked up by ordinal. Takes 16 bytes per ordinal, 12 * 7^r of them at resolution r: about 190 MB up to
+// resolution 7 and 1.3 GB up to 8. Finer cells are computed on each call.
+class Z7CentroidCache {
+public:
+    explicit Z7CentroidCache(int max_resolution, unsigned threads = 0) : max(max_resolution) {
+        first[0] = 0;
+        for (int r = 0; r <= max; r++)
+            first[r + 1] = first[r] + ordinal_count(r);
+        centers.resize(first[max + 1]);
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        const size_t slices = std::min<size_t>(threads, centers.size() / (1 << 14) + 1);
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < slices; s++) {
+            workers.emplace_back([this, s, slices] {
+                const auto &g = detail::geometry();
+                for (int r = 0; r <= max; r++) {
+                    for (uint64_t o = ordinal_count(r) * s / slices; o < ordinal_count(r) * (s + 1) / slices; o++) {
+                        const Z7Index cell = from_ordinal(o, r);
+                        // Cells of the exclusion zones don't exist.
+                        centers[first[r] + o] = detail::in_exclusion_zone(cell, g.exclusion[cell.hierarchy.base])
+                                                    ? Z7GeoPoint{std::numeric_limits<double>::quiet_NaN(),
+                                                                 std::numeric_limits<double>::quiet_NaN()}
+                                                    : Z7::to_geo(cell);
+                    }
+                }
+            });
+        }
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    int max_resolution() const { return max; }
+
+    // Same as Z7::to_geo().
+    Z7GeoPoint to_geo(const Z7Index &cell) const {
+        const int resolution = cell.resolution();
+        return resolution <= max ? centers[first[resolution] + ordinal(cell)] : Z7::to_geo(cell);
+    }
+
+    void to_geo(const Z7Index *cells, size_t count, double *lat, double *lon) const {
+        for (size_t i = 0; i < count; i++) {
+            const Z7GeoPoint p = to_geo(cells[i]);
+            lat[i] = p.lat;
+            lon[i] = p.lon;
+        }
+    }
+
+private:
+    int max;
+    // Position of the first ordinal of each resolution in centers.
+    std::array<uint64_t, 22> first;
+    std::vector<Z7GeoPoint> centers;
+};
+
+} // namespace Z7
+
+#endif // Z7_GEO_H
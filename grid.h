@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_GRID_H
+#define Z7_GRID_H
+
+#include "axial.h"
+#include "library.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Distances and shortest paths between cells, across base zones.
+//
+// The grid is flat but at the 12 vertices of the icosahedron, where 5 faces meet. A shortest path is then a straight
+// line through a chain of faces unfolded into a plane: the chart. Charts are unfolded once from the face of every
+// sector of every base zone, following neighbor_zones, through every chain of up to chart_depth faces. The frame of
+// each zone (see axial.h) lands in them turned by a multiple of 60 degrees and moved to the position of its vertex, so
+// cells keep their lattice coordinates. The distance is the shortest straight line from the cell to the other one in
+// any chart that stays inside its chain of faces.
+namespace Z7 {
+
+namespace detail {
+// Longest chain of faces unfolded. Shortest paths between any two cells cross fewer.
+inline constexpr int chart_depth = 8;
+
+// Digit of the direction k times 60 degrees counterclockwise from digit 1, and the other way around.
+inline constexpr std::array<uint8_t, 6> turn_digits{1, 3, 2, 6, 4, 5};
+inline constexpr std::array<uint8_t, 7> digit_turns{0, 0, 2, 1, 4, 5, 3};
+
+inline constexpr Hex hex_turn(const Hex &h, int turns) { return hex_times(h, digit_steps[turn_digits[turns % 6]]); }
+
+// A face of a chart, seen from one of its vertices: the sector of the zone from the direction of a digit to the one
+// 60 degrees counterclockwise, with the frame of the zone turned and its vertex at origin (in edges, as a lattice
+// point of resolution 0).
+struct Z7ChartFace {
+    uint8_t zone, sector, turns;
+    Hex origin;
+};
+
+// A face of a chart from each of its vertices: the one of the sector, then those at the start and the end of it.
+// The face was unfolded across the edge from `from` to `to` of its parent.
+struct Z7ChartNode {
+    std::array<Z7ChartFace, 3> corners;
+    int32_t parent;
+    Hex from, to;
+};
+
+// Every chain of faces unfolded from one face, and the nodes of each face (zone * 7 + sector, from any vertex).
+struct Z7Chart {
+    std::vector<Z7ChartNode> nodes;
+    std::array<std::vector<int32_t>, 12 * 7> faces;
+};
+
+// The face seen from the vertex at the start (or end) of the sector of another vertex. Around a vertex the faces are
+// counterclockwise, so from the vertex at the start of the sector the zone is at the end of the sector of the face,
+// and the other way around.
+inline Z7ChartFace chart_corner(const Z7ChartFace &face, bool start, const Z7Configuration &config) {
+    const uint8_t digit = start ? face.sector : face.sector * 3 % 7;
+    const uint8_t other = start ? face.sector * 3 % 7 : face.sector;
+    const uint8_t zone = config.neighbor_zones[face.zone][digit - 1];
+    const uint8_t third = config.neighbor_zones[face.zone][other - 1];
+    for (uint8_t sector = 1; sector < 7; sector++) {
+        if (sector == config.exclusion_zone[zone] * 5 % 7) // the gap
+            continue;
+        const uint8_t at_start = config.neighbor_zones[zone][sector - 1];
+        const uint8_t at_end = config.neighbor_zones[zone][sector * 3 % 7 - 1];
+        if (start ? at_start != third || at_end != face.zone : at_start != face.zone || at_end != third)
+            continue;
+        // The frame turns so the direction back to the zone of the face is opposite to the one that got here.
+        const uint8_t back = start ? sector * 3 % 7 : sector;
+        const int turns = (face.turns + digit_turns[digit] + 9 - digit_turns[back]) % 6;
+        const Hex step = hex_turn(digit_steps[digit], face.turns);
+        return {zone, sector, static_cast<uint8_t>(turns), {face.origin.a + step.a, face.origin.b + step.b}};
+    }
+    return {};
+}
+
+inline Z7ChartNode chart_node(const Z7ChartFace &face, int32_t parent, const Hex &from, const Hex &to,
+                              const Z7Configuration &config) {
+    return {{face, chart_corner(face, true, config), chart_corner(face, false, config)}, parent, from, to};
+}
+
+// Unfold the faces across the edges of a node not yet in its chain, recursively.
+inline void unfold(Z7Chart &chart, int32_t node, int depth, const Z7Configuration &config) {
+    if (depth == 0)
+        return;
+    for (size_t c = 0; c < 3; c++) {
+        // The edge along the start of the sector of each vertex. The face across it is the sector before, or the one
+        // before the gap with the frame turned 60 degrees, as its sides are glued.
+        const Z7ChartFace face = chart.nodes[node].corners[c];
+        const uint8_t exclusion = config.exclusion_zone[face.zone];
+        const Z7ChartFace next = face.sector == exclusion
+                                     ? Z7ChartFace{face.zone, static_cast<uint8_t>(exclusion * 4 % 7),
+                                                   static_cast<uint8_t>((face.turns + 1) % 6), face.origin}
+                                     : Z7ChartFace{face.zone, static_cast<uint8_t>(face.sector * 5 % 7), face.turns,
+                                                   face.origin};
+        const Hex step = hex_turn(digit_steps[face.sector], face.turns);
+        const Hex from = face.origin, to{face.origin.a + step.a, face.origin.b + step.b};
+        const Z7ChartNode &current = chart.nodes[node];
+        const auto same = [](const Hex &p, const Hex &q) { return p.a == q.a && p.b == q.b; };
+        if (current.parent >= 0 && ((same(current.from, from) && same(current.to, to)) ||
+                                    (same(current.from, to) && same(current.to, from))))
+            continue; // back to the parent
+        bool seen = false;
+        for (int32_t n = node; n >= 0 && !seen; n = chart.nodes[n].parent) {
+            for (const auto &corner: chart.nodes[n].corners)
+                seen |= corner.zone == next.zone && corner.sector == next.sector;
+        }
+        if (seen)
+            continue;
+        chart.nodes.push_back(chart_node(next, node, from, to, config));
+        unfold(chart, static_cast<int32_t>(chart.nodes.size() - 1), depth - 1, config);
+    }
+}
+
+// One chart for each sector of each zone (the gap has none), with the frame of the zone as is.
+inline std::vector<Z7Chart> make_charts(const Z7Configuration &config) {
+    std::vector<Z7Chart> charts(12 * 7);
+    for (uint8_t zone = 0; zone < 12; zone++) {
+        for (uint8_t sector = 1; sector < 7; sector++) {
+            if (sector == config.exclusion_zone[zone] * 5 % 7)
+                continue;
+            Z7Chart &chart = charts[zone * 7 + sector];
+            chart.nodes.push_back(chart_node({zone, sector, 0, {0, 0}}, -1, {0, 0}, {0, 0}, config));
+            unfold(chart, 0, chart_depth, config);
+            for (size_t n = 0; n < chart.nodes.size(); n++) {
+                for (const auto &corner: chart.nodes[n].corners)
+                    chart.faces[corner.zone * 7 + corner.sector].push_back(static_cast<int32_t>(n));
+            }
+        }
+    }
+    return charts;
+}
+
+// Charts of a configuration, made the first time they are asked for. They depend only on its exclusion and neighbor
+// zones, which are the key; those of igeo7 are kept apart to skip the lock.
+inline const std::vector<Z7Chart> &charts(const Z7Configuration &config) {
+    const auto same = [](const Z7Configuration &a, const Z7Configuration &b) {
+        return a.exclusion_zone == b.exclusion_zone && a.neighbor_zones == b.neighbor_zones;
+    };
+    static const std::vector<Z7Chart> default_charts = make_charts(igeo7);
+    if (same(config, igeo7))
+        return default_charts;
+    static std::mutex mutex;
+    static std::vector<std::pair<Z7Configuration, std::unique_ptr<const std::vector<Z7Chart>>>> cache;
+    const std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &[key, value]: cache) {
+        if (same(config, key))
+            return *value;
+    }
+    cache.emplace_back(config, std::make_unique<const std::vector<Z7Chart>>(make_charts(config)));
+    return *cache.back().second;
+}
+
+// Sector of the frame of a zone with the lattice point h of a resolution whose edge is `edge`. Points along the start
+// of the gap are in the sector before it.
+inline uint8_t sector_of_lattice(const Hex &h, const Hex &edge, uint8_t exclusion) {
+    for (const uint8_t digit: turn_digits) {
+        const Hex start = hex_times(edge, digit_steps[digit]), end = hex_times(edge, digit_steps[digit * 3 % 7]);
+        if (hex_cross(start, h) >= 0 && hex_cross(h, end) > 0)
+            return digit == exclusion * 5 % 7 ? exclusion * 4 % 7 : digit;
+    }
+    return exclusion == 1 ? 2 : 1; // the vertex, in any sector
+}
+
+// Lattice point of a cell in the frame of its zone. Cells in the gap are on the face after it, turned 60 degrees.
+inline Hex cell_position(const Z7Index &cell, const Hex &edge, const Z7Configuration &config) {
+    const Hex h = lattice_offset(cell, 0);
+    const uint8_t exclusion = config.exclusion_zone[cell.hierarchy.base];
+    const Hex before = hex_times(edge, digit_steps[exclusion * 5 % 7]), after = hex_times(edge, digit_steps[exclusion]);
+    return hex_cross(before, h) > 0 && hex_cross(h, after) > 0 ? hex_turn(h, 1) : h;
+}
+
+// Whether the segment from p to q touches the one from u to v.
+inline bool segments_touch(const Hex &p, const Hex &q, const Hex &u, const Hex &v) {
+    const auto side = [](const Hex &a, const Hex &b, const Hex &c) {
+        const int64_t x = hex_cross({b.a - a.a, b.b - a.b}, {c.a - a.a, c.b - a.b});
+        return (x > 0) - (x < 0);
+    };
+    return side(u, v, p) * side(u, v, q) <= 0 && side(p, q, u) * side(p, q, v) <= 0;
+}
+
+// The shortest straight line from a to b in the chart of a: its length, the node of the face of b and where b is.
+struct Z7ChartLine {
+    int64_t distance = -1;
+    int32_t node = -1;
+    Hex from, to;
+};
+
+inline Z7ChartLine chart_line(const Z7Index &a, const Z7Index &b, const Z7Configuration &config) {
+    const int resolution = a.resolution();
+    const Hex edge = refine({1, 0}, 0, resolution);
+    const uint8_t zone_a = a.hierarchy.base, zone_b = b.hierarchy.base;
+    Z7ChartLine res;
+    res.from = cell_position(a, edge, config);
+    const Hex position = cell_position(b, edge, config);
+    const uint8_t sector_b = sector_of_lattice(position, edge, config.exclusion_zone[zone_b]);
+    const uint8_t sector_a = sector_of_lattice(res.from, edge, config.exclusion_zone[zone_a]);
+    const Z7Chart &chart = charts(config)[zone_a * 7 + sector_a];
+    for (const int32_t n: chart.faces[zone_b * 7 + sector_b]) {
+        const Z7ChartNode &node = chart.nodes[n];
+        const Z7ChartFace &face = *std::find_if(node.corners.begin(), node.corners.end(), [&](const auto &corner) {
+            return corner.zone == zone_b && corner.sector == sector_b;
+        });
+        const Hex origin = hex_times(edge, face.origin), turned = hex_turn(position, face.turns);
+        const Hex to{origin.a + turned.a, origin.b + turned.b};
+        const int64_t distance = axial_distance({res.from.a, res.from.b}, {to.a, to.b});
+        if (res.distance >= 0 && distance >= res.distance)
+            continue;
+        // The line has to cross every edge of the chain of faces.
+        bool inside = true;
+        for (int32_t p = n; inside && chart.nodes[p].parent >= 0; p = chart.nodes[p].parent)
+            inside = segments_touch(res.from, to, hex_times(edge, chart.nodes[p].from),
+                                    hex_times(edge, chart.nodes[p].to));
+        if (inside)
+            res = {distance, n, res.from, to};
+    }
+    return res;
+}
+
+// The cell at the lattice point p of a chart, on one of the faces of the chain ending at node. Invalid if it is in
+// none of them.
+inline Z7Index chart_cell(const Z7Chart &chart, int32_t node, const Hex &p, int resolution,
+                          const Z7Configuration &config) {
+    const Hex edge = refine({1, 0}, 0, resolution);
+    for (int32_t n = node; n >= 0; n = chart.nodes[n].parent) {
+        for (const auto &corner: chart.nodes[n].corners) {
+            // Back to the frame of the zone, where the point has to be in the sector of the face.
+            const Hex origin = hex_times(edge, corner.origin);
+            const Hex h = hex_turn({p.a - origin.a, p.b - origin.b}, 6 - corner.turns);
+            const Hex start = hex_times(edge, digit_steps[corner.sector]);
+            const Hex end = hex_times(edge, digit_steps[corner.sector * 3 % 7]);
+            if (hex_cross(start, h) < 0 || hex_cross(h, end) < 0)
+                continue;
+            uint64_t digits = 0;
+            const Hex rest = hex_to_digits(h, resolution, digits);
+            if (rest.a != 0 || rest.b != 0)
+                continue;
+            const Z7Index cell{uint64_t{corner.zone} << 60 | digits | digits_below(resolution)};
+            // Points of the exclusion zone out of the gap are the cells turned into it.
+            return in_exclusion_zone(cell, config.exclusion_zone[corner.zone]) ? rotate(cell, 1) : cell;
+        }
+    }
+    return Z7Index::invalid();
+}
+} // namespace detail
+
+// Number of steps between two cells of the same resolution, from neighbor to neighbor. -1 if their resolutions
+// differ.
+inline int64_t grid_distance(const Z7Index &a, const Z7Index &b, const Z7Configuration &config = igeo7) {
+    if (a.resolution() != b.resolution())
+        return -1;
+    return detail::chart_line(a, b, config).distance;
+}
+
+// Cells of a shortest path from a to b, both included, into out. They follow the straight line between them, but
+// where it is not a path on the grid (next to a pentagon), which is then completed from neighbor to neighbor. Empty if
+// their resolutions differ.
+inline void grid_path(const Z7Index &a, const Z7Index &b, std::vector<Z7Index> &out,
+                      const Z7Configuration &config = igeo7) {
+    out.clear();
+    if (a.resolution() != b.resolution())
+        return;
+    const int resolution = a.resolution();
+    const detail::Z7ChartLine line = detail::chart_line(a, b, config);
+    const uint8_t sector = detail::sector_of_lattice(line.from, detail::refine({1, 0}, 0, resolution),
+                                                     config.exclusion_zone[a.hierarchy.base]);
+    const detail::Z7Chart &chart = detail::charts(config)[a.hierarchy.base * 7 + sector];
+    const int64_t n = line.distance;
+    out.push_back(a);
+    for (int64_t i = 1; i <= n; i++) {
+        // Round the point i / n of the way in cube coordinates (a, b, -a - b), nudged off the edges between cells.
+        const double t = static_cast<double>(i) / static_cast<double>(n);
+        const double x = line.from.a + (line.to.a - line.from.a) * t + 1e-6;
+        const double y = line.from.b + (line.to.b - line.from.b) * t + 1e-6;
+        double rx = std::round(x), ry = std::round(y);
+        const double rz = std::round(-x - y);
+        const double dx = std::abs(rx - x), dy = std::abs(ry - y), dz = std::abs(rz + x + y);
+        if (dx > dy && dx > dz)
+            rx = -ry - rz;
+        else if (dy > dz)
+            ry = -rx - rz;
+        const Z7Index &last = out.back();
+        const auto around = neighbors(last, config);
+        Z7Index next = i == n ? b
+                              : detail::chart_cell(chart, line.node,
+                                                   {static_cast<int64_t>(rx), static_cast<int64_t>(ry)}, resolution,
+                                                   config);
+        const bool on_path = std::find(around.begin(), around.end(), next) != around.end() &&
+                             (i == n || grid_distance(next, b, config) == n - i);
+        if (!on_path) {
+            for (const auto &neighbor: around) {
+                if (neighbor != Z7Index::invalid() && grid_distance(neighbor, b, config) == n - i) {
+                    next = neighbor;
+                    break;
+                }
+            }
+        }
+        out.push_back(next);
+    }
+}
+
+} // namespace Z7
+
+#endif // Z7_GRID_H
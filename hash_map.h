@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_HASH_MAP_H
+#define Z7_HASH_MAP_H
+
+#include "library.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Z7 {
+
+// Hash of a cell. Neighboring cells differ in their last digits and coarse cells only in their first ones (the rest
+// is padding with 7), so identity hashing clusters. Fold the top half down and multiply, twice, so every digit reaches
+// every bit.
+constexpr uint64_t hash(const Z7Index &ref) {
+    uint64_t x = ref.index;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    return x ^ x >> 32;
+}
+
+// Open addressing hash map from cells to values of type V (which must be default constructible), in the style of
+// Swiss tables. Slots are probed in groups of 8, with one control byte per slot: empty, deleted, or 7 bits of the
+// hash of its key. A whole group is matched against a key at once with bit tricks on a 64-bit word, and keys are only
+// compared for the (rare) false positives.
+template<typename V>
+class Z7HashMap {
+public:
+    Z7HashMap() { clear(); }
+
+    explicit Z7HashMap(size_t n) {
+        clear();
+        reserve(n);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return keys.size(); }
+
+    // Make room for `n` entries without rehashing.
+    void reserve(size_t n) {
+        size_t slots = group_size;
+        while (slots * 7 / 8 < n)
+            slots *= 2;
+        if (slots > capacity())
+            rehash(slots);
+    }
+
+    void clear() {
+        control.assign(group_size, empty_slot);
+        keys.assign(group_size, Z7Index{});
+        values.assign(group_size, V{});
+        count = 0;
+        deleted = 0;
+    }
+
+    V *find(const Z7Index &key) {
+        const size_t slot = find_slot(key, hash(key));
+        return slot == npos ? nullptr : &values[slot];
+    }
+
+    const V *find(const Z7Index &key) const { return const_cast<Z7HashMap *>(this)->find(key); }
+
+    bool contains(const Z7Index &key) const { return find(key) != nullptr; }
+
+    // Insert the value unless the key is already there. Returns the value in the map and whether it was inserted.
+    std::pair<V *, bool> insert(const Z7Index &key, V value) {
+        const uint64_t h = hash(key);
+        const size_t found = find_slot(key, h);
+        if (found != npos)
+            return {&values[found], false};
+        if ((count + deleted + 1) * 8 > capacity() * 7) {
+            rehash(count * 16 >= capacity() * 7 ? capacity() * 2 : capacity());
+        }
+        const size_t slot = free_slot(h);
+        if (control[slot] == deleted_slot)
+            deleted--;
+        control[slot] = tag(h);
+        keys[slot] = key;
+        values[slot] = std::move(value);
+        count++;
+        return {&values[slot], true};
+    }
+
+    // Insert many entries at once, reserving room for all of them first.
+    void insert(const Z7Index *in_keys, const V *in_values, size_t n) {
+        reserve(count + n);
+        for (size_t i = 0; i < n; i++)
+            insert(in_keys[i], in_values[i]);
+    }
+
+    V &operator[](const Z7Index &key) { return *insert(key, V{}).first; }
+
+    bool erase(const Z7Index &key) {
+        const size_t slot = find_slot(key, hash(key));
+        if (slot == npos)
+            return false;
+        control[slot] = deleted_slot;
+        values[slot] = V{};
+        count--;
+        deleted++;
+        return true;
+    }
+
+    // Call f(key, value) for every entry, in no particular order.
+    template<typename F>
+    void for_each(F &&f) const {
+        for (size_t slot = 0; slot < capacity(); slot++) {
+            if (control[slot] < 0x80)
+                f(keys[slot], values[slot]);
+        }
+    }
+
+private:
+    static constexpr size_t group_size = 8;
+    static constexpr size_t npos = ~size_t{0};
+    static constexpr uint8_t empty_slot = 0x80;
+    static constexpr uint8_t deleted_slot = 0xFE;
+    static constexpr uint64_t lsb = 0x0101010101010101ULL;
+    static constexpr uint64_t msb = 0x8080808080808080ULL;
+
+    // Low 7 bits of the hash go to the control bytes, the rest choose the first group to probe.
+    static uint8_t tag(uint64_t h) { return h & 0x7F; }
+    size_t first_group(uint64_t h) const { return (h >> 7) & (capacity() / group_size - 1); }
+
+    uint64_t load_group(size_t group) const {
+        uint64_t word;
+        std::memcpy(&word, control.data() + group * group_size, sizeof(word));
+        return word;
+    }
+
+    // Bytes of the group equal to the tag have their top bit set; rarely also the byte after a match.
+    static uint64_t match(uint64_t group, uint8_t t) {
+        const uint64_t x = group ^ (lsb * t);
+        return (x - lsb) & ~x & msb;
+    }
+
+    static uint64_t match_empty(uint64_t group) { return group & ~(group << 6) & msb; }
+    static uint64_t match_free(uint64_t group) { return group & ~(group << 7) & msb; }
+
+    // Slot of the byte of a match in a group, whatever the byte order of the host.
+    static size_t match_slot(uint64_t mask) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return Utils::countl_zero(mask) / 8;
+#else
+        return Utils::countr_zero(mask) / 8;
+#endif
+    }
+
+    static uint64_t next_match(uint64_t mask) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return mask & ~(uint64_t{1} << (63 - Utils::countl_zero(mask)));
+#else
+        return mask & (mask - 1);
+#endif
+    }
+
+    size_t find_slot(const Z7Index &key, uint64_t h) const {
+        const size_t mask = capacity() / group_size - 1;
+        for (size_t group = first_group(h), step = 1;; group = (group + step++) & mask) {
+            const uint64_t word = load_group(group);
+            for (uint64_t m = match(word, tag(h)); m != 0; m = next_match(m)) {
+                const size_t slot = group * group_size + match_slot(m);
+                if (keys[slot] == key)
+                    return slot;
+            }
+            if (match_empty(word) != 0)
+                return npos;
+        }
+    }
+
+    size_t free_slot(uint64_t h) const {
+        const size_t mask = capacity() / group_size - 1;
+        for (size_t group = first_group(h), step = 1;; group = (group + step++) & mask) {
+            const uint64_t m = match_free(load_group(group));
+            if (m != 0)
+                return group * group_size + match_slot(m);
+        }
+    }
+
+    void rehash(size_t slots) {
+        const auto old_control = std::exchange(control, std::vector<uint8_t>(slots, empty_slot));
+        const auto old_keys = std::exchange(keys, std::vector<Z7Index>(slots));
+        auto old_values = std::exchange(values, std::vector<V>(slots));
+        deleted = 0;
+        for (size_t slot = 0; slot < old_control.size(); slot++) {
+            if (old_control[slot] < 0x80) {
+                const uint64_t h = hash(old_keys[slot]);
+                const size_t free = free_slot(h);
+                control[free] = tag(h);
+                keys[free] = old_keys[slot];
+                values[free] = std::move(old_values[slot]);
+            }
+        }
+    }
+
+    std::vector<uint8_t> control;
+    std::vector<Z7Index> keys;
+    std::vector<V> values;
+    size_t count = 0;
+    size_t deleted = 0;
+};
+
+} // namespace Z7
+
+#endif // Z7_HASH_MAP_H
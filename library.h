@@ -5,11 +5,28 @@
 #define Z7_LIBRARY_H
 
 #include "BitFieldProxy.h"
+#include "gbt.h"
 #include "util.h"
 
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
 #include <random>
 #include <string>
+#include <utility>
+
+// With Z7_HEADER_ONLY defined the whole library lives in its headers (see library_inline.h), so the compiler can inline
+// and constant fold operator+, neighbors() and friends into the caller. Otherwise they are compiled into the Z7
+// library.
+#ifdef Z7_HEADER_ONLY
+#define Z7_INLINE inline
+#define Z7_CONSTEXPR constexpr
+#else
+#define Z7_INLINE
+#define Z7_CONSTEXPR
+#endif
 
 
 namespace Z7 {
@@ -144,27 +161,28 @@ struct Z7Index {
 
     // Determine the resolution based on the index. Because unused hierarchy levels are filled, we look for the first
     // zero.
-    constexpr int resolution() const { return hierarchy.i01 == 7 ? 0 : 20 - (Utils::countr_one(index) / 3); }
+    constexpr int resolution() const { return (*this)[1] == 7 ? 0 : 20 - (Utils::countr_one(index) / 3); }
 
     friend constexpr bool operator==(const Z7Index &lhs, const Z7Index &rhs) { return lhs.index == rhs.index; }
     friend constexpr bool operator!=(const Z7Index &lhs, const Z7Index &rhs) { return lhs.index != rhs.index; }
     std::string str() const;
 
-    // Pre-increment operator, follows the space filling curve order.
+    // Pre-increment operator, follows the space filling curve order. The last digits that are 6 become 0 and the one
+    // before them goes up by one, which is 7 past the last cell of the base zone; incrementing that (resolution 0)
+    // gives invalid(). Done on the whole word with no loop: the padding and the 6 digits after it are found with a lane
+    // compare, cleared with a mask, and the 1 is added right above them.
     constexpr Z7Index &operator++() noexcept {
-        auto i = resolution();
-        if (i == 0) {
+        using namespace GBT::Addition::SWAR;
+        const uint64_t padding = Utils::countr_one(index) / 3 * 3;
+        if (padding >= 60 || (index >> resolution_shift(1) & 0b111) == 7) {
             *this = invalid();
             return *this;
         }
-        uint64_t value = 0;
-        do {
-            value = const_cast<const Z7Index &>(*this)[i] + 1;
-            if (value == 7 && i > 1)
-                (*this)[i] = 0;
-            else
-                (*this)[i] = value;
-        } while (--i, value == 7 && i > 0);
+        const uint64_t padding_mask = (uint64_t{1} << padding) - 1;
+        // The first digit is never cleared, it takes the carry as is.
+        const uint64_t sixes = widen(zero_lanes(index ^ lane_lsb * 6)) | padding_mask;
+        const uint64_t carry = Utils::countr_one(sixes & digits_mask >> 3);
+        index = (index & ~(((uint64_t{1} << carry) - 1) ^ padding_mask)) + (uint64_t{1} << carry);
         return *this;
     }
 
@@ -176,11 +194,198 @@ struct Z7Index {
     }
 };
 
-Z7Index operator+(const Z7Index &a, const Z7Index &b);
-Z7Index operator-(const Z7Index &a);
+// GBT addition of two indexes in the same base zone. Missing digits of the coarser index count as zero. Returns
+// Z7Index::invalid() if the base zones differ or the sum leaves the base zone.
+Z7_CONSTEXPR Z7Index operator+(const Z7Index &a, const Z7Index &b);
+Z7_CONSTEXPR Z7Index operator-(const Z7Index &a);
+
+// Rotate the cell k times by 60 degrees around the center of its base zone, multiplying every digit by 5 (mod 7).
+constexpr Z7Index rotate(const Z7Index &ref, uint8_t k) {
+    using namespace GBT::Addition::SWAR;
+    return Z7Index{(ref.index & ~digits_mask) | rotate_digits(ref.index & digits_mask, k)};
+}
+
+// Mask of the digits finer than the given resolution.
+constexpr uint64_t digits_below(int resolution) { return GBT::Addition::SWAR::digits_mask >> (3 * resolution); }
+
+// Ancestor of the cell at the given resolution, or the cell itself if it is not finer than that.
+constexpr Z7Index parent(const Z7Index &ref, int resolution) { return Z7Index{ref.index | digits_below(resolution)}; }
+
+// Descendant of the cell at the given resolution that shares its center (all new digits are 0). The resolution must not
+// be coarser than the one of the cell.
+constexpr Z7Index center_child(const Z7Index &ref, int resolution) {
+    return Z7Index{ref.index & ~(digits_below(ref.resolution()) & ~digits_below(resolution))};
+}
+
+// The seven children of the cell one resolution down, indexed by their last digit. Children of a pentagon include one
+// in the exclusion zone, which is not a cell. All are invalid for a cell at resolution 20.
+constexpr std::array<Z7Index, 7> children(const Z7Index &ref) {
+    std::array<Z7Index, 7> res{};
+    const int resolution = ref.resolution();
+    if (resolution == 20) {
+        for (auto &child: res)
+            child = Z7Index::invalid();
+        return res;
+    }
+    const uint64_t center = center_child(ref, resolution + 1).index;
+    const uint64_t shift = Z7Index::resolution_shift(resolution + 1);
+    for (uint64_t d = 0; d < 7; d++)
+        res[d] = Z7Index{center | d << shift};
+    return res;
+}
+
+// Whether ref is ancestor or one of its descendants.
+constexpr bool is_descendant_of(const Z7Index &ref, const Z7Index &ancestor) {
+    return parent(ref, ancestor.resolution()) == ancestor;
+}
+
+// Inclusive range of Z7Index::index values.
+struct Z7IndexRange {
+    uint64_t first;
+    uint64_t last;
+};
+
+// Range of the descendants of the cell at the given resolution, which must not be coarser than the one of the cell.
+// Indexes follow the space filling curve, so the cells at that resolution within the range are exactly the
+// descendants; a sorted sequence of them can be searched with two binary searches.
+constexpr Z7IndexRange descendant_range(const Z7Index &ref, int resolution) {
+    const uint64_t new_digits = digits_below(ref.resolution()) & ~digits_below(resolution);
+    const uint64_t sixes = GBT::Addition::SWAR::lane_lsb * 6;
+    return {ref.index & ~new_digits, (ref.index & ~new_digits) | (new_digits & sixes)};
+}
+
+constexpr bool contains(const Z7IndexRange &range, uint64_t index) {
+    return range.first <= index && index <= range.last;
+}
+constexpr bool contains(const Z7IndexRange &range, const Z7Index &cell) { return contains(range, cell.index); }
+
+namespace detail {
+// Order of index, the space filling curve.
+constexpr bool index_less(const Z7Index &a, const Z7Index &b) { return a.index < b.index; }
+
+inline constexpr std::array<uint64_t, 21> powers_of_7 = [] {
+    std::array<uint64_t, 21> res{1};
+    for (size_t i = 1; i < res.size(); i++)
+        res[i] = res[i - 1] * 7;
+    return res;
+}();
+} // namespace detail
+
+// Number of ordinals at the given resolution: 7^resolution for each of the 12 base zones. Those of the cells in the
+// exclusion zones of the pentagons are never used.
+constexpr uint64_t ordinal_count(int resolution) { return 12 * detail::powers_of_7[resolution]; }
+
+// Dense number of the cell among those at its resolution, in [0, ordinal_count()): the base zone and digits read as a
+// base 7 number. Follows the order of index.
+constexpr uint64_t ordinal(const Z7Index &ref) {
+    const int resolution = ref.resolution();
+    // Right align the digits, then merge neighboring lanes pairwise: 3 bit digits into 6 bit base 49 lanes, then 12
+    // bit base 7^4 lanes and 24 bit base 7^8 lanes. The top 4 digits are left in bits 48 and up.
+    uint64_t v = (ref.index & GBT::Addition::SWAR::digits_mask) >> Z7Index::resolution_shift(resolution);
+    v = (v & 0x01C71C71C71C71C7ULL) + ((v >> 3) & 0x01C71C71C71C71C7ULL) * 7;
+    v = (v & 0x003F03F03F03F03FULL) + ((v >> 6) & 0x003F03F03F03F03FULL) * 49;
+    v = (v & 0x0FFF000FFF000FFFULL) + ((v >> 12) & 0x0FFF000FFF000FFFULL) * 2401;
+    v = (v & 0xFFFF000000FFFFFFULL) + ((v >> 24) & 0x0000000000FFFFFFULL) * detail::powers_of_7[8];
+    v = (v & 0xFFFFFFFFFFFFULL) + (v >> 48) * detail::powers_of_7[16];
+    return ref.hierarchy.base * detail::powers_of_7[resolution] + v;
+}
+
+// Inverse of ordinal(): the cell at the given resolution with that ordinal.
+constexpr Z7Index from_ordinal(uint64_t ordinal, int resolution) {
+    const uint64_t size = detail::powers_of_7[resolution];
+    const uint64_t base = ordinal / size;
+    const uint64_t rest = ordinal % size;
+    // Two independent chains of 10 digits, each fitting in 32 bits.
+    uint32_t high = static_cast<uint32_t>(rest / detail::powers_of_7[10]);
+    uint32_t low = static_cast<uint32_t>(rest % detail::powers_of_7[10]);
+    uint64_t v = 0;
+    for (int i = 0; i < 10; i++) {
+        v |= uint64_t{low % 7} << (3 * i) | uint64_t{high % 7} << (3 * (i + 10));
+        low /= 7;
+        high /= 7;
+    }
+    return Z7Index{base << 60 | v << Z7Index::resolution_shift(resolution) | digits_below(resolution)};
+}
+
+// The descendants of a cell at a resolution, or a part of them, in index order. Cells in the exclusion zones are
+// included, as in ordinals. Going from one to the next is Z7Index::operator++, and split() hands out parts for
+// parallel loops:
+//
+//     const Z7Range all("08"_Z7, 9);
+//     for (size_t t = 0; t < threads; t++)
+//         workers.emplace_back([=] { for (const Z7Index &cell: all.split(t, threads)) use(cell); });
+class Z7Range {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Z7Index;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Z7Index *;
+        using reference = const Z7Index &;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(const Z7Index &cell)
+            : cell(cell), last(Z7Index::resolution_shift(cell.resolution())) {}
+        constexpr reference operator*() const { return cell; }
+        constexpr pointer operator->() const { return &cell; }
+        // Six steps out of seven only add one to the last digit.
+        constexpr iterator &operator++() {
+            if ((cell.index >> last & 7) != 6)
+                cell.index += uint64_t{1} << last;
+            else
+                ++cell;
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            const iterator current = *this;
+            ++*this;
+            return current;
+        }
+        friend constexpr bool operator==(const iterator &a, const iterator &b) { return a.cell == b.cell; }
+        friend constexpr bool operator!=(const iterator &a, const iterator &b) { return a.cell != b.cell; }
+
+    private:
+        Z7Index cell;
+        uint64_t last = 0; // shift of the last digit
+    };
+
+    // All the descendants of ancestor at the resolution, which must not be coarser than the one of ancestor.
+    constexpr Z7Range(const Z7Index &ancestor, int resolution)
+        : Z7Range(ancestor, resolution, 0, detail::powers_of_7[resolution - ancestor.resolution()]) {}
+
+    // The descendants from the first-th (in index order) to the one before the last-th.
+    constexpr Z7Range(const Z7Index &ancestor, int resolution, uint64_t first, uint64_t last)
+        : ancestor(ancestor), resolution(resolution), first(first), last(last) {}
+
+    constexpr uint64_t size() const { return last - first; }
+    constexpr bool empty() const { return last == first; }
+
+    constexpr iterator begin() const { return iterator{at(first)}; }
+    // The cell after the last one, or the first one when empty, so the iterators meet.
+    constexpr iterator end() const { return empty() ? begin() : ++iterator{at(last - 1)}; }
+
+    // Part `part` of `parts` about equal ones, in order.
+    constexpr Z7Range split(size_t part, size_t parts) const {
+        const auto start = [&](uint64_t p) {
+            return first + size() / parts * p + std::min<uint64_t>(p, size() % parts);
+        };
+        return {ancestor, resolution, start(part), start(part + 1)};
+    }
+
+private:
+    // The n-th descendant: the ordinal of the first one plus n.
+    constexpr Z7Index at(uint64_t n) const {
+        return from_ordinal(ordinal(center_child(ancestor, resolution)) + n, resolution);
+    }
+
+    Z7Index ancestor;
+    int resolution;
+    uint64_t first, last;
+};
 
 constexpr size_t first_non_zero(const Z7Index &f) {
-    if (f.hierarchy.i01 == 7)
+    if (f[1] == 7)
         return 0;
 
     // mask out the base and count leading zeros
@@ -188,7 +393,38 @@ constexpr size_t first_non_zero(const Z7Index &f) {
     return (Utils::countl_zero(f.index & base_mask) - 4) / 3 + 1;
 }
 
-std::array<Z7Index, 6> neighbors(const Z7Index &ref, const Z7Configuration &config);
+// Longest text of an index: two digits for the base zone and one per resolution.
+inline constexpr size_t max_chars = 22;
+
+// Write the text of the cell, as str() does, to [first, last) without allocating. Returns the end of what was written,
+// or nullptr if it does not fit.
+char *to_chars(char *first, char *last, const Z7Index &ref);
+
+// Write the text of `count` cells to [first, last), each followed by a newline. Returns the end of what was written, or
+// nullptr if it does not fit; (max_chars + 1) * count characters are always enough.
+char *to_chars(char *first, char *last, const Z7Index *cells, size_t count);
+
+// Parse the text of a cell at the start of [first, last), as std::from_chars does: the two digit base zone (up to 11)
+// followed by up to 20 digits from 0 to 6. On success ptr is the first character after them; otherwise value is left
+// untouched and ec is std::errc::invalid_argument, or std::errc::result_out_of_range for more than 20 digits.
+std::from_chars_result from_chars(const char *first, const char *last, Z7Index &value);
+
+struct Z7_parse_result {
+    const char *ptr;
+    std::errc ec;
+    size_t count;
+};
+
+// Parse the cells in [first, last) separated by newlines (optionally "\r\n") or commas into out, which has room for
+// `capacity` of them. Stops at the first error, when out is full or at the end of the input. Returns where it stopped,
+// the error if any and the number of cells parsed.
+Z7_parse_result from_chars(const char *first, const char *last, Z7Index *out, size_t capacity);
+
+Z7_CONSTEXPR std::array<Z7Index, 6> neighbors(const Z7Index &ref, const Z7Configuration &config);
+
+// Same as neighbors() for `count` cells, writing the neighbors of in[i] to out[i]. Several cells are processed at
+// once (4 or 8 with AVX2 or AVX-512), only cells crossing zones or next to a pentagon go through neighbors().
+void neighbors_batch(const Z7Index *in, size_t count, std::array<Z7Index, 6> *out, const Z7Configuration &config);
 
 struct Z7_carry {
     Z7Index z7;
@@ -196,18 +432,162 @@ struct Z7_carry {
 };
 
 
+// Because we're adding a single known digit we can optimize the addition. This is just a very specific case of
+// operator+: the direction is a carry into the given resolution.
 template<size_t N>
-Z7_carry neighbor(const Z7Index &ref, size_t resolution);
+constexpr Z7_carry neighbor(const Z7Index &ref, size_t resolution) {
+    static_assert(0 < N && N < 7, "N must be in 1..6");
+    Z7_carry res{ref, 0};
+
+    // Propagate the carry.
+    uint8_t carry = N;
+    for (auto i = resolution; i > 0; --i) {
+        const auto [c, r0] = GBT::Addition::lookup(i, ref[i], carry);
+        res.z7[i] = r0;
+        carry = c;
+        if (carry == 0)
+            return res;
+    }
+
+    // If we still have a carry after handling all digits then we're out of bounds.
+    res.carry = carry;
+    // res.hierarchy.base = 15; // invalid base zone. Leave the rest, that can be useful.
+    return res;
+}
+
+namespace detail {
+// Base zone of a cell, and the cell moved to another base zone. They work on the word rather than the bit fields, which
+// can not be read in a constant expression once the word was set.
+constexpr uint8_t base_of(const Z7Index &cell) { return static_cast<uint8_t>(cell.index >> 60); }
+constexpr Z7Index with_base(const Z7Index &cell, uint8_t base) {
+    return Z7Index{(cell.index & GBT::Addition::SWAR::digits_mask) | uint64_t{base} << 60};
+}
+
+// Whether the cell is in the sector that doesn't exist around the pentagon of its base zone.
+constexpr bool in_exclusion_zone(const Z7Index &cell, uint8_t exclusion) {
+    const auto cell_first_non_zero = first_non_zero(cell);
+    return cell_first_non_zero <= static_cast<size_t>(cell.resolution()) && cell[cell_first_non_zero] == exclusion;
+}
+
+constexpr std::array<Z7Index, 6> neighbors(const Z7Index &ref, const Z7Configuration &config) {
+    constexpr uint8_t size = 6;
+
+    const auto resolution = ref.resolution();
+    const uint8_t base = base_of(ref);
+    const auto exclusion = config.exclusion_zone[base];
+
+    // base only
+    if (resolution == 0) {
+        // this is a special case. The return depends only on the config data.
+        std::array<Z7Index, size> result;
+        for (int i = 0; i < 6; i++) {
+            result[i] = Z7Index::invalid();
+            if (i + 1 != exclusion) {
+                result[i] = with_base(result[i], config.neighbor_zones[base][i]);
+            }
+        }
+        return result;
+    }
+
+    // create the neighbors
+    std::array<Z7_carry, size> result_carry = {neighbor<1>(ref, resolution), neighbor<2>(ref, resolution),
+                                               neighbor<3>(ref, resolution), neighbor<4>(ref, resolution),
+                                               neighbor<5>(ref, resolution), neighbor<6>(ref, resolution)};
+
+    // deal with carry, crossing between zones
+    for (auto &r: result_carry) {
+        if (r.carry != 0) {
+            const uint8_t zone = config.neighbor_zones[base][r.carry - 1];
+            r.z7 = with_base(r.z7, zone);
+            if (zone == 0 || zone == 11) {
+                // coming from tropical zone to polar zone 0. Rotate the neighbors
+                auto rotations = config.rotations[base];
+                if (ref[1] == 6 || ref[1] == 1) { // should this be in config?
+                    rotations++;
+                }
+                r.z7 = rotate(r.z7, rotations);
+            }
+            if (base == 0 || base == 11) {
+                auto row = ref[1];
+                auto col = std::as_const(r.z7)[1];
+                if (base == 11) {
+                    row = 7 - row;
+                    col = 7 - col;
+                }
+                r.z7 = rotate(r.z7, config.pole_0_rotations[row - 1][col - 1]);
+            }
+        }
+    }
+    std::array<Z7Index, size> result{
+            result_carry[0].z7, result_carry[1].z7, result_carry[2].z7,
+            result_carry[3].z7, result_carry[4].z7, result_carry[5].z7,
+    };
+
+    // if we are in a pentagon we invalidate one neighbor here.
+    const uint64_t data_only = (ref.index & ~(0b1111ULL << (20 * 3))) >> (3 * (20 - resolution));
+    if (data_only == 0 && exclusion > 0 && exclusion <= 6) {
+        result[exclusion - 1] = Z7Index::invalid();
+        return result;
+    }
+
+    // move points out of the exclusion zone
+    const auto ref_first_non_zero = first_non_zero(ref);
+    if (ref_first_non_zero < 1) {
+        return result; // we should never get where with proper config.
+    }
+
+    // find out how we should rotate the cells if needed
+    const auto reference_zone = ref[ref_first_non_zero];
+    uint8_t rotations = 0;
+    if ((reference_zone * 5) % 7 == exclusion) {
+        rotations = 1; // multiply by 5, rotate counterclockwise
+    } else if ((reference_zone * 3) % 7 == exclusion) {
+        rotations = 5; // multiply by 3, rotate clockwise
+    }
+
+    // rotate needed cells. The digits before the first non zero one are zero, so rotating all of them is the same.
+    if (rotations > 0) {
+        for (auto &elem: result) {
+            if (in_exclusion_zone(elem, exclusion)) {
+                elem = rotate(elem, rotations);
+            }
+        }
+    }
+
+    return result;
+}
+} // namespace detail
+
+// The default IGEO7 configuration, as a constant to specialize on.
+inline constexpr Z7Configuration igeo7{};
+
+// Same as neighbors(ref, config) for a configuration known at compile time, so its tables are constants of the
+// computation. For example `neighbors(ref)` or `neighbors<my_config>(ref)`.
+template<const Z7Configuration &Config = igeo7>
+constexpr std::array<Z7Index, 6> neighbors(const Z7Index &ref) {
+    return detail::neighbors(ref, Config);
+}
+
+// Number of cells within k steps of a cell, away from pentagons. 0 for a negative k.
+constexpr size_t grid_disk_size(int k) { return k < 0 ? 0 : 3 * static_cast<size_t>(k) * (k + 1) + 1; }
+
+// Number of cells exactly k steps away from a cell, away from pentagons. 0 for a negative k.
+constexpr size_t grid_ring_size(int k) { return k < 0 ? 0 : k == 0 ? 1 : 6 * static_cast<size_t>(k); }
 
-extern template Z7_carry neighbor<1>(const Z7Index &ref, size_t resolution);
-extern template Z7_carry neighbor<2>(const Z7Index &ref, size_t resolution);
-extern template Z7_carry neighbor<3>(const Z7Index &ref, size_t resolution);
-extern template Z7_carry neighbor<4>(const Z7Index &ref, size_t resolution);
-extern template Z7_carry neighbor<5>(const Z7Index &ref, size_t resolution);
-extern template Z7_carry neighbor<6>(const Z7Index &ref, size_t resolution);
+// Write all cells within k steps of ref to out, which must have grid_disk_size(k) slots. Cells are ordered by distance,
+// ref first. Returns the number of cells written, which is less than grid_disk_size(k) when a pentagon is in reach;
+// the remaining slots are set to Z7Index::invalid(). Nothing is written for a negative k, and 0 returned.
+size_t grid_disk(const Z7Index &ref, int k, Z7Index *out, const Z7Configuration &config);
+
+// Same as grid_disk() for the cells exactly k steps away. out must have grid_ring_size(k) slots.
+size_t grid_ring(const Z7Index &ref, int k, Z7Index *out, const Z7Configuration &config);
 
 } // namespace Z7
 
 inline constexpr Z7::Z7Index operator""_Z7(const char *str, std::size_t) { return Z7::Z7Index{str}; }
 
+#ifdef Z7_HEADER_ONLY
+#include "library_inline.h"
+#endif
+
 #endif // Z7_LIBRARY_H
@@ -0,0 +1,401 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+// Definitions of the functions declared in library.h. They are compiled into the Z7 library by library.cpp, or
+// included by library.h itself when Z7_HEADER_ONLY is defined.
+
+#ifndef Z7_LIBRARY_INLINE_H
+#define Z7_LIBRARY_INLINE_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace Z7 {
+
+Z7_INLINE std::string Z7Index::str() const {
+    char text[max_chars];
+    return {text, to_chars(text, text + max_chars, *this)};
+}
+
+namespace detail {
+// Write the ASCII text of the 8 digits in the low 24 bits of x, the most significant one first.
+Z7_INLINE void spread_digits(char *out, uint64_t x) {
+    // Move each 3 bit digit to its own byte: 12 bits per 32 bit half, 6 bits per 16 bits, then 3 bits per byte.
+    x &= 0xFFFFFF;
+    x = (x | x << 20) & 0x00000FFF00000FFFULL;
+    x = (x | x << 10) & 0x003F003F003F003FULL;
+    x = (x | x << 5) & 0x0707070707070707ULL;
+    x += 0x3030303030303030ULL; // '0' in every byte
+    for (int i = 0; i < 8; i++)
+        out[i] = static_cast<char>(x >> (8 * (7 - i)));
+}
+
+// Write the base zone and all 20 digits of the index, 24 characters whatever its resolution.
+Z7_INLINE void write_chars(char *out, const Z7Index &ref) {
+    out[0] = static_cast<char>('0' + ref.hierarchy.base / 10);
+    out[1] = static_cast<char>('0' + ref.hierarchy.base % 10);
+    spread_digits(out + 2, ref.index >> 36);
+    spread_digits(out + 10, ref.index >> 12);
+    spread_digits(out + 18, ref.index << 12);
+}
+} // namespace detail
+
+Z7_INLINE char *to_chars(char *first, char *last, const Z7Index &ref) {
+    const size_t size = 2 + ref.resolution();
+    if (static_cast<size_t>(last - first) < size)
+        return nullptr;
+    char text[26];
+    detail::write_chars(text, ref);
+    std::copy(text, text + size, first);
+    return first + size;
+}
+
+Z7_INLINE char *to_chars(char *first, char *last, const Z7Index *cells, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (last - first >= 26) {
+            // Room to write every digit in place, keeping only those of its resolution.
+            detail::write_chars(first, cells[i]);
+            first += 2 + cells[i].resolution();
+        } else {
+            first = to_chars(first, last, cells[i]);
+            if (first == nullptr || first == last)
+                return nullptr;
+        }
+        *first++ = '\n';
+    }
+    return first;
+}
+
+namespace detail {
+// Load up to 8 characters, the first one in the top byte. Missing ones are zero.
+Z7_INLINE uint64_t load_chars(const char *p, const char *last) {
+    if (last - p >= 8)
+        return Utils::load_big_endian(p);
+    uint64_t w = 0;
+    for (size_t i = 0; p + i != last; i++)
+        w |= uint64_t{static_cast<uint8_t>(p[i])} << (8 * (7 - i));
+    return w;
+}
+
+// Number of leading characters of w that are digits from 0 to 6.
+Z7_INLINE size_t count_digits(uint64_t w) {
+    const uint64_t x = w ^ 0x3030303030303030ULL; // '0' to '6' become 0 to 6
+    // Bytes above 6 get their top bit set. Adding to the low 7 bits never carries into the next byte.
+    const uint64_t invalid = (x | ((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7979797979797979ULL)) & 0x8080808080808080ULL;
+    return Utils::countl_zero(invalid) / 8;
+}
+
+// Inverse of spread_digits(): pack the digits in the 8 bytes of w into 24 bits.
+Z7_INLINE uint64_t pack_digits(uint64_t w) {
+    w &= 0x0707070707070707ULL;
+    w = (w | w >> 5) & 0x003F003F003F003FULL;
+    w = (w | w >> 10) & 0x00000FFF00000FFFULL;
+    return (w | w >> 20) & 0xFFFFFF;
+}
+} // namespace detail
+
+Z7_INLINE std::from_chars_result from_chars(const char *first, const char *last, Z7Index &value) {
+    if (last - first < 2 || first[0] < '0' || first[0] > '1' || first[1] < '0' || first[1] > '9')
+        return {first, std::errc::invalid_argument};
+    const uint64_t base = (first[0] - '0') * 10 + (first[1] - '0');
+    if (base > 11)
+        return {first, std::errc::invalid_argument};
+
+    // 8 digits at a time: digits 1 to 8 go to bits 36 to 59, 9 to 16 to bits 12 to 35 and 17 to 20 to bits 0 to 11.
+    const char *p = first + 2;
+    uint64_t digits = 0;
+    size_t resolution = 0;
+    for (int chunk = 0; chunk < 3; chunk++) {
+        const uint64_t w = detail::load_chars(p, last);
+        const size_t count = detail::count_digits(w);
+        const uint64_t packed = detail::pack_digits(w);
+        digits |= chunk < 2 ? packed << (36 - 24 * chunk) : packed >> 12;
+        resolution += count;
+        p += count;
+        if (count < 8)
+            break;
+    }
+    if (resolution > 20)
+        return {first, std::errc::result_out_of_range};
+    if (p != last && *p >= '7' && *p <= '9')
+        return {first, std::errc::invalid_argument};
+
+    const auto res = static_cast<int>(resolution);
+    value = Z7Index{base << 60 | (digits & GBT::Addition::SWAR::used_digits(res)) | digits_below(res)};
+    return {p, std::errc()};
+}
+
+Z7_INLINE Z7_parse_result from_chars(const char *first, const char *last, Z7Index *out, size_t capacity) {
+    size_t count = 0;
+    while (first != last && count < capacity) {
+        const auto result = from_chars(first, last, out[count]);
+        if (result.ec != std::errc())
+            return {result.ptr, result.ec, count};
+        count++;
+        first = result.ptr;
+        if (first != last && *first == '\r')
+            first++;
+        if (first != last) {
+            if (*first != '\n' && *first != ',')
+                return {first, std::errc::invalid_argument, count};
+            first++;
+        }
+    }
+    return {first, std::errc(), count};
+}
+
+Z7_CONSTEXPR Z7Index operator-(const Z7Index &a) {
+    Z7Index res{a.index};
+    for (int i = a.resolution(); i >= 1; i--) {
+        const auto e = a[i];
+        res[i] = (e == 0 ? 0 : 7 - e);
+    }
+    return res;
+}
+
+Z7_CONSTEXPR Z7Index operator+(const Z7Index &a, const Z7Index &b) {
+    if (a.hierarchy.base != b.hierarchy.base) {
+        return Z7Index::invalid();
+    }
+
+    using namespace GBT::Addition::SWAR;
+    const int resolution = std::max(a.resolution(), b.resolution());
+    const uint64_t used = used_digits(resolution);
+
+    // Work in residue space so every lane is plain mod 7 arithmetic, whatever its rotation.
+    uint64_t overflow = 0;
+    const uint64_t sum =
+            add_residues(to_residue(zero_padding(a.index, used)), to_residue(zero_padding(b.index, used)), overflow);
+    if (overflow != 0) {
+        return Z7Index::invalid();
+    }
+    return Z7Index{(a.index & ~digits_mask) | to_residue(sum) | (digits_mask & ~used)};
+}
+
+Z7_CONSTEXPR std::array<Z7Index, 6> neighbors(const Z7Index &ref, const Z7Configuration &config) {
+    return detail::neighbors(ref, config);
+}
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+namespace detail {
+// What neighbors_block() needs to know to match neighbors() for a cell.
+struct BlockCell {
+    bool scalar; // base cells and pentagon centers, and any cell with neighbors crossing into another zone
+    uint8_t exclusion; // non zero for cells next to the exclusion zone, whose neighbors in it are rotated out
+};
+
+Z7_INLINE BlockCell block_cell(const Z7Index &ref, int resolution, const Z7Configuration &config) {
+    if (resolution == 0)
+        return {true, 0};
+    const auto ref_first_non_zero = first_non_zero(ref);
+    if (ref_first_non_zero > static_cast<size_t>(resolution))
+        return {true, 0};
+    const auto exclusion = config.exclusion_zone[ref.hierarchy.base];
+    const auto reference_zone = ref[ref_first_non_zero];
+    if ((reference_zone * 5) % 7 == exclusion || (reference_zone * 3) % 7 == exclusion)
+        return {false, exclusion};
+    return {false, 0};
+}
+
+// Neighbors of Lanes::size cells at once.
+Z7_INLINE void neighbors_block(const Z7Index *in, std::array<Z7Index, 6> *out, const Z7Configuration &config) {
+    using namespace GBT::Addition::SWAR;
+    constexpr size_t L = Lanes::size;
+    using W = Lanes;
+
+    std::array<uint64_t, L> refs, used, units, results, overflows;
+    std::array<BlockCell, L> cells;
+    for (size_t l = 0; l < L; l++) {
+        const auto resolution = in[l].resolution();
+        refs[l] = in[l].index;
+        used[l] = used_digits(resolution);
+        units[l] = resolution == 0 ? 0 : 1ULL << Z7Index::resolution_shift(resolution);
+        cells[l] = block_cell(in[l], resolution, config);
+    }
+
+    const W ref = W::load(refs.data());
+    const W u = W::load(used.data());
+    const W unit = W::load(units.data());
+    const W base = to_residue(zero_padding(ref, u));
+    const W head = (ref & ~W(digits_mask)) | (W(digits_mask) & ~u);
+    const std::array<W, 6> steps{unit, unit << 1, unit | unit << 1, unit << 2, unit | unit << 2, unit << 1 | unit << 2};
+    for (size_t n = 0; n < 6; n++) {
+        W overflow(0);
+        const W sum = add_residues(base, to_residue(steps[n]), overflow);
+        (head | to_residue(sum)).store(results.data());
+        overflow.store(overflows.data());
+        for (size_t l = 0; l < L; l++) {
+            const Z7Index neighbor{results[l]};
+            out[l][n] = neighbor;
+            cells[l].scalar = cells[l].scalar || overflows[l] != 0 ||
+                              (cells[l].exclusion != 0 && in_exclusion_zone(neighbor, cells[l].exclusion));
+        }
+    }
+
+    for (size_t l = 0; l < L; l++) {
+        if (cells[l].scalar)
+            out[l] = Z7::neighbors(in[l], config);
+    }
+}
+} // namespace detail
+#endif
+
+Z7_INLINE void neighbors_batch(const Z7Index *in, size_t count, std::array<Z7Index, 6> *out,
+                               const Z7Configuration &config) {
+    size_t i = 0;
+#if defined(__AVX512F__) || defined(__AVX2__)
+    using GBT::Addition::SWAR::Lanes;
+    for (; i + Lanes::size <= count; i += Lanes::size) {
+        detail::neighbors_block(in + i, out + i, config);
+    }
+#endif
+    // Without vector extensions the word parallel adder is no faster than neighbor<N> for a single cell.
+    for (; i < count; i++) {
+        out[i] = neighbors(in[i], config);
+    }
+}
+
+namespace detail {
+// The six directions in turning order (each is the previous one rotated by 60 degrees), for even (CCW) and odd (CW)
+// resolutions. In residue space turning is multiplying by 5; CW digits swap 1 <-> 2 and 5 <-> 6 to get there.
+inline constexpr std::array<std::array<uint8_t, 6>, 2> turning_directions{{{1, 5, 4, 6, 2, 3}, {2, 6, 4, 5, 1, 3}}};
+
+Z7_INLINE Z7_carry neighbor_towards(const Z7Index &ref, size_t resolution, uint8_t direction) {
+    switch (direction) {
+        case 1:
+            return neighbor<1>(ref, resolution);
+        case 2:
+            return neighbor<2>(ref, resolution);
+        case 3:
+            return neighbor<3>(ref, resolution);
+        case 4:
+            return neighbor<4>(ref, resolution);
+        case 5:
+            return neighbor<5>(ref, resolution);
+        default:
+            return neighbor<6>(ref, resolution);
+    }
+}
+
+// Walks the hexagonal spiral around a cell, as long as the lattice is flat: the spiral must neither leave the base
+// zone nor enter its exclusion zone (which it always does before any pentagon distortion can matter).
+class Spiral {
+public:
+    Spiral(const Z7Index &ref, const Z7Configuration &config) :
+        cell(ref), resolution(ref.resolution()), exclusion(config.exclusion_zone[ref.hierarchy.base]),
+        directions(turning_directions[resolution % 2]) {}
+
+    // Move one cell in the given turning direction (0..5). Returns false if the lattice is not flat there.
+    bool step(size_t turn) {
+        if (resolution == 0)
+            return false;
+        const auto next = neighbor_towards(cell, resolution, directions[turn]);
+        cell = next.z7;
+        return next.carry == 0 && !in_exclusion_zone(cell, exclusion);
+    }
+
+    // Write the ring at distance k from the center, starting at the current cell (ring start) and ending back there.
+    bool ring(int k, Z7Index *out) {
+        for (size_t side = 0; side < 6; side++) {
+            for (int i = 0; i < k; i++) {
+                *out++ = cell;
+                if (!step(side))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    Z7Index cell;
+
+private:
+    const int resolution;
+    const uint8_t exclusion;
+    const std::array<uint8_t, 6> &directions;
+};
+
+// Turning direction leading from the center to the start of each ring.
+inline constexpr size_t ring_start = 4;
+
+// Breadth first search over neighbors(), for disks where the spiral can't be used. Each ring is sorted.
+Z7_INLINE std::vector<std::vector<Z7Index>> rings_bfs(const Z7Index &ref, int k, const Z7Configuration &config) {
+    std::vector<std::vector<Z7Index>> rings{{ref}};
+    for (int r = 1; r <= k; r++) {
+        std::vector<Z7Index> candidates;
+        for (const auto &cell: rings[r - 1]) {
+            for (const auto &n: Z7::neighbors(cell, config)) {
+                if (n != Z7Index::invalid())
+                    candidates.push_back(n);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), index_less);
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        // Neighbors of ring r - 1 are in rings r - 2, r - 1 or r.
+        std::vector<Z7Index> ring;
+        for (int previous = std::max(r - 2, 0); previous < r; previous++) {
+            ring.clear();
+            std::set_difference(candidates.begin(), candidates.end(), rings[previous].begin(), rings[previous].end(),
+                                std::back_inserter(ring), index_less);
+            std::swap(ring, candidates);
+        }
+        rings.push_back(std::move(candidates));
+    }
+    return rings;
+}
+
+Z7_INLINE size_t fill_invalid(Z7Index *out, size_t written, size_t size) {
+    std::fill(out + written, out + size, Z7Index::invalid());
+    return written;
+}
+} // namespace detail
+
+Z7_INLINE size_t grid_disk(const Z7Index &ref, int k, Z7Index *out, const Z7Configuration &config) {
+    if (k < 0)
+        return 0;
+    detail::Spiral spiral(ref, config);
+    out[0] = ref;
+    bool flat = true;
+    for (int r = 1; r <= k && flat; r++) {
+        flat = spiral.step(detail::ring_start) && spiral.ring(r, out + grid_disk_size(r - 1));
+    }
+    if (flat)
+        return grid_disk_size(k);
+
+    size_t written = 0;
+    for (const auto &ring: detail::rings_bfs(ref, k, config)) {
+        written = std::copy(ring.begin(), ring.end(), out + written) - out;
+    }
+    return detail::fill_invalid(out, written, grid_disk_size(k));
+}
+
+Z7_INLINE size_t grid_ring(const Z7Index &ref, int k, Z7Index *out, const Z7Configuration &config) {
+    if (k < 0)
+        return 0;
+    if (k == 0) {
+        out[0] = ref;
+        return 1;
+    }
+
+    // The cells between the center and the ring are checked too, they are part of the disk.
+    detail::Spiral spiral(ref, config);
+    bool flat = true;
+    for (int r = 1; r <= k && flat; r++) {
+        flat = spiral.step(detail::ring_start);
+    }
+    if (flat && spiral.ring(k, out))
+        return grid_ring_size(k);
+
+    const auto rings = detail::rings_bfs(ref, k, config);
+    const size_t written = std::copy(rings[k].begin(), rings[k].end(), out) - out;
+    return detail::fill_invalid(out, written, grid_ring_size(k));
+}
+
+} // namespace Z7
+
+#endif // Z7_LIBRARY_INLINE_H
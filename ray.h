@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_RAY_H
+#define Z7_RAY_H
+
+#include "library.h"
+
+#include <cstdint>
+
+namespace Z7 {
+
+// Walk from a cell in a straight line, one neighbor at a time in the direction of a digit (1 to 6). Each step adds the
+// digit at the resolution of the cell and carries into the previous digits only as far as needed, the same loop as
+// neighbor<N>(). What it saves over neighbors() is the other five neighbors and the zone checks: the position of the
+// first non zero digit is kept, and the exclusion zone is only looked at when the carry reaches it. Steps leaving the
+// base zone or entering its exclusion zone are done by neighbors(), and the direction is then the opposite of the one
+// back to the previous cell, as the frames of the two sides may be rotated.
+//
+//     for (Z7RayIterator ray(start, 3, config); count > 0; --count, ++ray)
+//         use(*ray);
+class Z7RayIterator {
+public:
+    Z7RayIterator(const Z7Index &start, uint8_t direction, const Z7Configuration &config = igeo7)
+        : cell(start), resolution(start.resolution()), leading(static_cast<int>(first_non_zero(start))),
+          step(direction), config(&config) {}
+
+    const Z7Index &operator*() const { return cell; }
+    const Z7Index *operator->() const { return &cell; }
+
+    // Direction of the next step, which changes when crossing into another frame.
+    uint8_t direction() const { return step; }
+
+    Z7RayIterator &operator++() {
+        Z7Index next = cell;
+        uint8_t carry = step;
+        int r = resolution;
+        for (; r > 0 && carry != 0; --r) {
+            const auto [c, digit] = GBT::Addition::lookup(r, static_cast<uint8_t>(*next[r]), carry);
+            next[r] = digit;
+            carry = c;
+        }
+        // Digits up to r are unchanged. If those include the first non zero one, it is still not the exclusion zone.
+        if (carry == 0 && r >= leading) {
+            cell = next;
+        } else if (carry == 0 && !detail::in_exclusion_zone(next, config->exclusion_zone[detail::base_of(next)])) {
+            cell = next;
+            leading = static_cast<int>(first_non_zero(cell));
+        } else {
+            cross();
+        }
+        return *this;
+    }
+
+private:
+    // The step done by neighbors(). At the center of a pentagon there is no neighbor towards the exclusion zone; the
+    // ray goes on towards the next direction in turning order.
+    void cross() {
+        const auto around = neighbors(cell, *config);
+        Z7Index next = around[step - 1];
+        if (next == Z7Index::invalid())
+            next = around[step * 3 % 7 - 1];
+        const auto back = neighbors(next, *config);
+        for (uint8_t d = 1; d < 7; d++) {
+            if (back[d - 1] == cell)
+                step = 7 - d;
+        }
+        cell = next;
+        leading = static_cast<int>(first_non_zero(cell));
+    }
+
+    Z7Index cell;
+    int resolution;
+    int leading; // position of the first non zero digit of cell
+    uint8_t step;
+    const Z7Configuration *config;
+};
+
+} // namespace Z7
+
+#endif // Z7_RAY_H
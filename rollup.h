@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#ifndef Z7_ROLLUP_H
+#define Z7_ROLLUP_H
+
+#include "library.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Z7 {
+
+enum class Z7Aggregate { sum, min, max, count };
+
+template<typename T>
+using Z7Values = std::vector<std::pair<Z7Index, T>>;
+
+namespace detail {
+template<typename T>
+T aggregate(Z7Aggregate op, const T &a, const T &b) {
+    switch (op) {
+        case Z7Aggregate::min:
+            return std::min(a, b);
+        case Z7Aggregate::max:
+            return std::max(a, b);
+        default:
+            return a + b; // sum, and count once every cell counts as 1
+    }
+}
+
+// Roll up sorted cells at one resolution. Cells of a group are contiguous, so only one group per resolution is open at
+// a time. When it closes (the next cell has another ancestor there) it is written out and folded into the next
+// coarser one.
+template<typename T>
+std::vector<Z7Values<T>> rollup_slice(const std::pair<Z7Index, T> *cells, size_t count, int resolution,
+                                      Z7Aggregate op) {
+    std::vector<Z7Values<T>> res(resolution + 1);
+    std::vector<std::pair<Z7Index, T>> open(resolution + 1);
+    std::vector<bool> is_open(resolution + 1, false);
+
+    const auto add = [&](auto &add, int r, const Z7Index &cell, const T &value) -> void {
+        if (is_open[r] && open[r].first == cell) {
+            open[r].second = aggregate(op, open[r].second, value);
+            return;
+        }
+        if (is_open[r]) {
+            res[r].push_back(open[r]);
+            if (r > 0)
+                add(add, r - 1, parent(open[r].first, r - 1), open[r].second);
+        }
+        open[r] = {cell, value};
+        is_open[r] = true;
+    };
+    for (size_t i = 0; i < count; i++)
+        add(add, resolution, cells[i].first, op == Z7Aggregate::count ? T{1} : cells[i].second);
+
+    for (int r = resolution; r >= 0; r--) {
+        if (!is_open[r])
+            continue;
+        res[r].push_back(open[r]);
+        if (r > 0)
+            add(add, r - 1, parent(open[r].first, r - 1), open[r].second);
+    }
+    return res;
+}
+} // namespace detail
+
+// Aggregate values of cells at one resolution into all their ancestors. Cells must be sorted by index and at the same
+// resolution; repeated cells are aggregated too. Returns the aggregates at each resolution from 0 to the one of the
+// cells, sorted by index. The input is split in `threads` slices (0 for all cores), rolled up in parallel and stitched
+// back together where a group crosses from one slice to the next.
+template<typename T>
+std::vector<Z7Values<T>> rollup(const std::pair<Z7Index, T> *cells, size_t count, Z7Aggregate op,
+                                unsigned threads = 0) {
+    if (count == 0)
+        return {};
+    const int resolution = cells[0].first.resolution();
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t slices = std::min<size_t>(threads, count / (1 << 16) + 1);
+    if (slices == 1)
+        return detail::rollup_slice(cells, count, resolution, op);
+
+    std::vector<std::vector<Z7Values<T>>> parts(slices);
+    std::vector<std::thread> workers;
+    for (size_t s = 0; s < slices; s++) {
+        const size_t first = count * s / slices;
+        const size_t last = count * (s + 1) / slices;
+        workers.emplace_back([&, s, first, last] {
+            parts[s] = detail::rollup_slice(cells + first, last - first, resolution, op);
+        });
+    }
+    for (auto &worker: workers)
+        worker.join();
+
+    std::vector<Z7Values<T>> res(resolution + 1);
+    for (int r = 0; r <= resolution; r++) {
+        for (const auto &part: parts) {
+            auto it = part[r].begin();
+            if (!res[r].empty() && it != part[r].end() && res[r].back().first == it->first) {
+                res[r].back().second = detail::aggregate(op, res[r].back().second, it->second);
+                ++it;
+            }
+            res[r].insert(res[r].end(), it, part[r].end());
+        }
+    }
+    return res;
+}
+
+} // namespace Z7
+
+#endif // Z7_ROLLUP_H
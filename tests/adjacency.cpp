@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../adjacency.h"
+
+namespace {
+// Adjacency with a binary search for each neighbor.
+Z7::Z7Adjacency AdjacencyBySearch(const Z7::Z7CellSet &cells) {
+    Z7::Z7Adjacency res;
+    res.offsets.push_back(0);
+    for (const auto &cell: cells) {
+        std::vector<uint64_t> targets;
+        for (const auto &neighbor: Z7::neighbors(cell, Z7::igeo7)) {
+            if (neighbor != Z7::Z7Index::invalid() && cells.contains(neighbor))
+                targets.push_back(std::lower_bound(cells.begin(), cells.end(), neighbor, Z7::detail::index_less) -
+                                  cells.begin());
+        }
+        std::sort(targets.begin(), targets.end());
+        res.targets.insert(res.targets.end(), targets.begin(), targets.end());
+        res.offsets.push_back(res.targets.size());
+    }
+    return res;
+}
+} // namespace
+
+TEST(Adjacency, Small) {
+    // A pentagon with three of its neighbors, and a cell away from them.
+    const Z7::Z7CellSet cells({"0800"_Z7, "0801"_Z7, "0803"_Z7, "0806"_Z7, "0833"_Z7});
+    const Z7::Z7Adjacency graph = Z7::build_adjacency(cells, Z7::igeo7);
+    EXPECT_EQ((std::vector<uint64_t>{0, 3, 5, 7, 8, 8}), graph.offsets);
+    EXPECT_EQ((std::vector<uint64_t>{1, 2, 3, 0, 2, 0, 1, 0}), graph.targets);
+
+    const Z7::Z7Adjacency empty = Z7::build_adjacency(Z7::Z7CellSet(), Z7::igeo7);
+    EXPECT_EQ(std::vector<uint64_t>{0}, empty.offsets);
+    EXPECT_TRUE(empty.targets.empty());
+}
+
+TEST(Adjacency, MatchesSearch) {
+    std::vector<Z7::Z7Index> mask;
+    for (uint64_t o = 0; o < Z7::ordinal_count(5); o++) {
+        const Z7::Z7Index cell = Z7::from_ordinal(o, 5);
+        if (o % 3 != 0 && !Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base]))
+            mask.push_back(cell);
+    }
+    const Z7::Z7CellSet cells(mask);
+    const Z7::Z7Adjacency expected = AdjacencyBySearch(cells);
+    for (unsigned threads: {1u, 4u}) {
+        const Z7::Z7Adjacency graph = Z7::build_adjacency(cells, Z7::igeo7, threads);
+        EXPECT_EQ(expected.offsets, graph.offsets);
+        EXPECT_EQ(expected.targets, graph.targets);
+    }
+    // Every edge is there both ways.
+    for (uint64_t v = 0; v < cells.size(); v++) {
+        for (uint64_t e = expected.offsets[v]; e < expected.offsets[v + 1]; e++) {
+            const uint64_t w = expected.targets[e];
+            const auto first = expected.targets.begin() + expected.offsets[w];
+            const auto last = expected.targets.begin() + expected.offsets[w + 1];
+            ASSERT_TRUE(std::binary_search(first, last, v));
+        }
+    }
+}
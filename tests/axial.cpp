@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../axial.h"
+
+namespace {
+// Random existing cells at a resolution.
+std::vector<Z7::Z7Index> RandomCells(size_t count, int resolution, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Z7::Z7Index> res;
+    while (res.size() < count) {
+        const Z7::Z7Index cell = Z7::from_ordinal(rng() % Z7::ordinal_count(resolution), resolution);
+        if (!Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base]))
+            res.push_back(cell);
+    }
+    return res;
+}
+} // namespace
+
+TEST(Z7Axial, Simple) {
+    EXPECT_EQ(Z7::to_axial("08"_Z7, 0), (Z7::Z7Axial{0, 0}));
+    EXPECT_EQ(Z7::to_axial("081"_Z7, 0), (Z7::Z7Axial{1, 0}));
+    EXPECT_EQ(Z7::to_axial("083"_Z7, 0), (Z7::Z7Axial{0, 1}));
+    EXPECT_EQ(Z7::to_axial("0810"_Z7, 1), (Z7::Z7Axial{0, 0}));
+    EXPECT_EQ(Z7::from_axial("08"_Z7, {1, 0}, 1, Z7::igeo7), "081"_Z7);
+    EXPECT_EQ(Z7::axial_distance({0, 0}, {2, -1}), 2);
+    EXPECT_EQ(Z7::axial_distance({0, 0}, {2, 1}), 3);
+    // Out of the zone, and in its exclusion zone.
+    EXPECT_EQ(Z7::from_axial("08"_Z7, {7, 0}, 1, Z7::igeo7), Z7::Z7Index::invalid());
+    EXPECT_EQ(Z7::from_axial("08"_Z7, {0, 0}, 1, Z7::igeo7), "080"_Z7);
+    const uint8_t exclusion = Z7::igeo7.exclusion_zone[8];
+    const auto step = Z7::detail::digit_steps[exclusion];
+    EXPECT_EQ(Z7::from_axial("08"_Z7, {step.a, step.b}, 1, Z7::igeo7), Z7::Z7Index::invalid());
+}
+
+TEST(Z7Axial, RoundTrip) {
+    for (int resolution = 0; resolution <= 20; resolution++) {
+        for (const auto &cell: RandomCells(200, resolution, resolution)) {
+            for (int anchor_resolution = 0; anchor_resolution <= resolution; anchor_resolution++) {
+                const Z7::Z7Index anchor = Z7::parent(cell, anchor_resolution);
+                const Z7::Z7Axial axial = Z7::to_axial(cell, anchor_resolution);
+                EXPECT_EQ(Z7::from_axial(anchor, axial, resolution, Z7::igeo7), cell)
+                    << cell.str() << " " << anchor_resolution;
+            }
+        }
+    }
+}
+
+TEST(Z7Axial, Neighbors) {
+    // Neighbors in the same base zone are one step away, in the direction of a digit.
+    for (int resolution: {1, 2, 3, 8, 15, 20}) {
+        for (const auto &cell: RandomCells(500, resolution, resolution)) {
+            const Z7::Z7Axial axial = Z7::to_axial(cell, 0);
+            for (const auto &neighbor: Z7::neighbors(cell)) {
+                if (neighbor == Z7::Z7Index::invalid() || neighbor.hierarchy.base != cell.hierarchy.base)
+                    continue;
+                if (Z7::axial_distance(axial, Z7::to_axial(neighbor, 0)) == 1)
+                    continue;
+                // Unless they are on both sides of the exclusion zone of the pentagon, which is not in the lattice.
+                const uint8_t exclusion = Z7::igeo7.exclusion_zone[cell.hierarchy.base];
+                const uint8_t a = cell[Z7::first_non_zero(cell)], b = neighbor[Z7::first_non_zero(neighbor)];
+                EXPECT_EQ(a * b % 7, exclusion * exclusion % 7) << cell.str() << " " << neighbor.str();
+                EXPECT_NE(a, b) << cell.str() << " " << neighbor.str();
+            }
+            const Z7::Z7Index anchor = Z7::parent(cell, resolution - 1);
+            const Z7::Z7Axial local = Z7::to_axial(cell, resolution - 1);
+            for (uint8_t d = 1; d < 7; d++) {
+                const auto step = Z7::detail::digit_steps[d];
+                const Z7::Z7Index next = Z7::from_axial(anchor, {local.q + step.a, local.r + step.b}, resolution,
+                                                        Z7::igeo7);
+                if (next == Z7::Z7Index::invalid())
+                    continue;
+                const auto n = Z7::neighbors(cell);
+                EXPECT_NE(std::find(n.begin(), n.end(), next), n.end()) << cell.str() << " " << next.str();
+            }
+        }
+    }
+}
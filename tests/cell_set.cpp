@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../cell_set.h"
+
+namespace {
+std::vector<Z7::Z7Index> RandomCells(std::mt19937_64 &generator, size_t count, int resolution) {
+    std::vector<Z7::Z7Index> cells;
+    for (size_t i = 0; i < count; i++) {
+        auto cell = Z7::parent(Z7::Z7Index{uint64_t{8} << 60}, 0);
+        for (int r = 1; r <= resolution; r++)
+            cell[r] = generator() % 7;
+        cells.push_back(cell);
+    }
+    return cells;
+}
+
+std::vector<uint64_t> Indexes(const Z7::Z7CellSet &set) {
+    std::vector<uint64_t> res;
+    for (const auto &cell: set)
+        res.push_back(cell.index);
+    return res;
+}
+
+std::vector<uint64_t> SortedIndexes(const std::vector<Z7::Z7Index> &cells) {
+    std::set<uint64_t> res;
+    for (const auto &cell: cells)
+        res.insert(cell.index);
+    return {res.begin(), res.end()};
+}
+} // namespace
+
+TEST(CellSet, Construction) {
+    std::mt19937_64 generator(17);
+    const auto cells = RandomCells(generator, 200000, 7);
+    const Z7::Z7CellSet set(cells);
+    EXPECT_EQ(SortedIndexes(cells), Indexes(set));
+    EXPECT_EQ(set, Z7::Z7CellSet(cells, 1));
+    EXPECT_EQ(set, Z7::Z7CellSet(cells, 3));
+    for (size_t i = 0; i < 100; i++)
+        EXPECT_TRUE(set.contains(cells[i]));
+    EXPECT_FALSE(set.contains("0912"_Z7));
+}
+
+TEST(CellSet, Algebra) {
+    std::mt19937_64 generator(19);
+    for (const size_t size: {0, 10, 1000}) {
+        const auto a = RandomCells(generator, 5000, 5);
+        const auto b = RandomCells(generator, size, 5);
+        const auto sa = SortedIndexes(a), sb = SortedIndexes(b);
+        const Z7::Z7CellSet A(a), B(b);
+        std::vector<uint64_t> expected;
+        std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+        EXPECT_EQ(expected, Indexes(Z7::set_union(A, B)));
+        EXPECT_EQ(expected, Indexes(Z7::set_union(B, A)));
+        expected.clear();
+        std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+        EXPECT_EQ(expected, Indexes(Z7::set_intersection(A, B)));
+        EXPECT_EQ(expected, Indexes(Z7::set_intersection(B, A)));
+        expected.clear();
+        std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+        EXPECT_EQ(expected, Indexes(Z7::set_difference(A, B)));
+        expected.clear();
+        std::set_difference(sb.begin(), sb.end(), sa.begin(), sa.end(), std::back_inserter(expected));
+        EXPECT_EQ(expected, Indexes(Z7::set_difference(B, A)));
+    }
+}
+
+TEST(CellSet, DescendantsOf) {
+    const Z7::Z7CellSet set({"081"_Z7, "0812"_Z7, "08120"_Z7, "081266"_Z7, "0812666666666666666666"_Z7,
+                             "0812000000000000000000"_Z7, "0813"_Z7, "0811"_Z7, "09"_Z7});
+    const auto [first, last] = set.descendants_of("0812"_Z7);
+    EXPECT_EQ(std::vector<uint64_t>({"0812000000000000000000"_Z7.index, "08120"_Z7.index,
+                                     "0812666666666666666666"_Z7.index, "081266"_Z7.index, "0812"_Z7.index}),
+              std::vector<uint64_t>(SortedIndexes({first, last})));
+    EXPECT_EQ(5, last - first);
+    const auto none = set.descendants_of("0814"_Z7);
+    EXPECT_EQ(none.first, none.second);
+}
+
+TEST(CellSet, Compact) {
+    const Z7::Z7Configuration config{};
+    std::vector<Z7::Z7Index> cells{"0811"_Z7, "08135"_Z7, "09"_Z7};
+    for (const auto &child: Z7::children("0812"_Z7))
+        cells.push_back(child);
+    for (const auto &child: Z7::children("08133"_Z7))
+        cells.push_back(child);
+    const auto compacted = Z7::compact(Z7::Z7CellSet(cells), config);
+    EXPECT_EQ(Z7::Z7CellSet({"0811"_Z7, "0812"_Z7, "08133"_Z7, "08135"_Z7, "09"_Z7}), compacted);
+    EXPECT_EQ(Z7::uncompact(Z7::Z7CellSet(cells), 5, config), Z7::uncompact(compacted, 5, config));
+
+    // A whole base zone, including the pentagon at its center with 6 children.
+    const Z7::Z7CellSet zone = Z7::uncompact(Z7::Z7CellSet({"08"_Z7}), 4, config);
+    EXPECT_EQ(2401 - (343 + 49 + 7 + 1), zone.size());
+    EXPECT_EQ(Z7::Z7CellSet({"08"_Z7}), Z7::compact(zone, config));
+    EXPECT_EQ(6, Z7::compact(Z7::Z7CellSet({"0800"_Z7, "0801"_Z7, "0803"_Z7, "0804"_Z7, "0805"_Z7, "0806"_Z7}), config)
+                         .size());
+    EXPECT_EQ(Z7::Z7CellSet({"080"_Z7}),
+              Z7::compact(Z7::Z7CellSet({"0800"_Z7, "0801"_Z7, "0802"_Z7, "0803"_Z7, "0804"_Z7, "0806"_Z7}), config));
+
+    // Round trip of random sets.
+    std::mt19937_64 generator(23);
+    for (int i = 0; i < 20; i++) {
+        const Z7::Z7CellSet set(Z7::uncompact(Z7::Z7CellSet({"0812"_Z7}), 6, config));
+        std::vector<Z7::Z7Index> some;
+        for (const auto &cell: set)
+            if (generator() % 8 != 0)
+                some.push_back(cell);
+        const Z7::Z7CellSet original = Z7::Z7CellSet::from_sorted(some);
+        const auto compact = Z7::compact(original, config);
+        EXPECT_LT(compact.size(), original.size());
+        EXPECT_EQ(original, Z7::uncompact(compact, 6, config));
+    }
+}
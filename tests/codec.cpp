@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../codec.h"
+
+namespace {
+std::vector<Z7::Z7Index> Decode(const Z7::Z7CompressedColumn &column) {
+    std::vector<Z7::Z7Index> cells(column.size());
+    column.decode(cells.data());
+    return cells;
+}
+} // namespace
+
+TEST(Codec, Empty) {
+    const Z7::Z7CompressedColumn column(nullptr, 0);
+    EXPECT_EQ(0, column.size());
+    EXPECT_EQ(0, column.blocks());
+    EXPECT_TRUE(Decode(column).empty());
+    EXPECT_TRUE(Decode(Z7::Z7CompressedColumn{}).empty());
+}
+
+TEST(Codec, Sorted) {
+    std::vector<Z7::Z7Index> cells;
+    Z7::Z7Index cell{"0823456012345601234560"};
+    for (int i = 0; i < 1000; i++)
+        cells.push_back(cell++);
+    const Z7::Z7CompressedColumn column(cells.data(), cells.size());
+    EXPECT_EQ(cells.size(), column.size());
+    EXPECT_EQ(8, column.blocks());
+    EXPECT_EQ(cells, Decode(column));
+    EXPECT_LT(column.words().size() * 4, cells.size()); // consecutive cells take a few bits each
+
+    std::array<Z7::Z7Index, Z7::Z7CompressedColumn::block_size> block;
+    EXPECT_EQ(1000 - 7 * 128, column.decode_block(7, block.data()));
+    EXPECT_EQ(cells[7 * 128], column.block_first(7));
+    EXPECT_EQ(cells[7 * 128 + 3], block[3]);
+
+    const auto copy = Z7::Z7CompressedColumn::from_words(column.words().data(), column.words().size());
+    EXPECT_EQ(cells, Decode(copy));
+}
+
+TEST(Codec, AnyOrder) {
+    std::mt19937_64 generator(13);
+    for (const size_t size: {1, 127, 128, 129, 5000}) {
+        std::vector<Z7::Z7Index> cells;
+        for (size_t i = 0; i < size; i++)
+            cells.emplace_back(generator());
+        const Z7::Z7CompressedColumn column(cells.data(), cells.size());
+        EXPECT_EQ(cells, Decode(column));
+        EXPECT_EQ(cells, Decode(Z7::Z7CompressedColumn::from_words(column.words().data(), column.words().size())));
+
+        // Sorted with repeats and gaps of every width.
+        std::sort(cells.begin(), cells.end(), [](const auto &a, const auto &b) { return a.index < b.index; });
+        for (size_t i = 1; i < size; i += 3)
+            cells[i] = cells[i - 1];
+        EXPECT_EQ(cells, Decode(Z7::Z7CompressedColumn(cells.data(), cells.size())));
+
+        std::vector<Z7::Z7Index> same(size, cells[0]);
+        EXPECT_EQ(same, Decode(Z7::Z7CompressedColumn(same.data(), same.size())));
+    }
+}
+
+TEST(Codec, Corrupt) {
+    std::vector<Z7::Z7Index> cells;
+    Z7::Z7Index cell{"0823456012345601234560"};
+    for (int i = 0; i < 300; i++)
+        cells.push_back(cell++);
+    std::vector<uint64_t> words = Z7::Z7CompressedColumn(cells.data(), cells.size()).words();
+
+    // Every truncation is rejected, down to no header at all.
+    for (size_t count = 0; count < words.size(); count++)
+        EXPECT_THROW(Z7::Z7CompressedColumn::from_words(words.data(), count), std::invalid_argument) << count;
+
+    auto corrupt = words;
+    corrupt[1] = 2; // blocks for 300 cells are 3
+    EXPECT_THROW(Z7::Z7CompressedColumn::from_words(corrupt.data(), corrupt.size()), std::invalid_argument);
+    corrupt = words;
+    corrupt[0] = ~uint64_t{0};
+    EXPECT_THROW(Z7::Z7CompressedColumn::from_words(corrupt.data(), corrupt.size()), std::invalid_argument);
+    corrupt = words;
+    corrupt[3] = (corrupt[3] & ~uint64_t{0xFF}) | 65; // width
+    EXPECT_THROW(Z7::Z7CompressedColumn::from_words(corrupt.data(), corrupt.size()), std::invalid_argument);
+    corrupt = words;
+    corrupt[5] = uint64_t{1} << 40 | (corrupt[5] & 0xFF); // offset
+    EXPECT_THROW(Z7::Z7CompressedColumn::from_words(corrupt.data(), corrupt.size()), std::invalid_argument);
+    corrupt = words;
+    corrupt[7] = 1 << 8 | (corrupt[7] & 0xFF); // offset into the headers
+    EXPECT_THROW(Z7::Z7CompressedColumn::from_words(corrupt.data(), corrupt.size()), std::invalid_argument);
+
+    EXPECT_EQ(cells, Decode(Z7::Z7CompressedColumn::from_words(words.data(), words.size())));
+}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "../file.h"
+
+namespace {
+// A file in the temporary directory, removed when it goes out of scope. Its name has the test and the process in it,
+// as both test binaries may run the same test at once.
+struct TempFile {
+    TempFile()
+        : path((std::filesystem::temp_directory_path() /
+                ("z7_file_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + "_" +
+                 std::to_string(getpid())))
+                       .string()) {}
+    TempFile(const TempFile &) = delete;
+    TempFile &operator=(const TempFile &) = delete;
+    ~TempFile() { std::remove(path.c_str()); }
+
+    const std::string path;
+};
+
+std::vector<Z7::Z7Index> SomeCells() {
+    std::vector<Z7::Z7Index> cells;
+    Z7::Z7Index cell{"0823456012345601234560"};
+    for (int i = 0; i < 10000; i++)
+        cells.push_back(cell++);
+    cells.push_back(Z7::Z7Index{"11"});
+    cells.push_back(Z7::Z7Index{"0812345"});
+    return cells;
+}
+
+std::vector<Z7::Z7Index> ReadAll(const std::string &path, Z7::Z7FileFormat format, size_t chunk) {
+    Z7::Z7FileReader reader(path, format);
+    std::vector<Z7::Z7Index> cells;
+    for (auto c = reader.next(chunk); c.size > 0; c = reader.next(chunk))
+        cells.insert(cells.end(), c.begin(), c.end());
+    return cells;
+}
+} // namespace
+
+TEST(File, RoundTrip) {
+    const auto cells = SomeCells();
+    for (const auto format: {Z7::Z7FileFormat::text, Z7::Z7FileFormat::binary}) {
+        const TempFile file;
+        const auto &path = file.path;
+        {
+            Z7::Z7FileWriter writer(path, format);
+            writer.write(cells.data(), 5000);
+            writer.write(cells.data() + 5000, cells.size() - 5000);
+            writer.close();
+        }
+        EXPECT_EQ(cells, ReadAll(path, format, 1000));
+        EXPECT_EQ(cells, ReadAll(path, format, cells.size() + 1));
+    }
+}
+
+TEST(File, Text) {
+    const TempFile file;
+    const auto &path = file.path;
+    std::ofstream(path) << "0812345\n11\n";
+    EXPECT_EQ(std::vector<Z7::Z7Index>({Z7::Z7Index{"0812345"}, Z7::Z7Index{"11"}}),
+              ReadAll(path, Z7::Z7FileFormat::text, 10));
+
+    std::ofstream(path) << "0812345\n0812395\n";
+    Z7::Z7FileReader reader(path, Z7::Z7FileFormat::text);
+    EXPECT_THROW(reader.next(), std::system_error);
+}
+
+TEST(File, Empty) {
+    const TempFile file;
+    const auto &path = file.path;
+    std::ofstream{path};
+    EXPECT_TRUE(ReadAll(path, Z7::Z7FileFormat::text, 10).empty());
+    EXPECT_TRUE(ReadAll(path, Z7::Z7FileFormat::binary, 10).empty());
+}
+
+TEST(File, Missing) {
+    EXPECT_THROW(Z7::Z7FileReader("/nonexistent/z7", Z7::Z7FileFormat::binary), std::system_error);
+}
+
+TEST(File, TruncatedBinary) {
+    const TempFile file;
+    const auto &path = file.path;
+    std::ofstream(path) << "0812345";
+    EXPECT_THROW(Z7::Z7FileReader(path, Z7::Z7FileFormat::binary), std::system_error);
+    EXPECT_NO_THROW(Z7::Z7FileReader(path, Z7::Z7FileFormat::text));
+}
+
+TEST(File, Closed) {
+    const TempFile file;
+    const auto &path = file.path;
+    const auto cells = SomeCells();
+    Z7::Z7FileWriter writer(path, Z7::Z7FileFormat::binary);
+    writer.close();
+    EXPECT_NO_THROW(writer.close());
+    EXPECT_THROW(writer.write(cells.data(), cells.size()), std::logic_error);
+}
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "../flood_fill.h"
+
+namespace {
+// Cells by step from the seeds, with a queue and a map.
+std::vector<std::vector<Z7::Z7Index>> FloodByQueue(const std::vector<Z7::Z7Index> &seeds,
+                                                   const std::function<bool(const Z7::Z7Index &)> &inside) {
+    std::map<uint64_t, size_t> steps;
+    std::queue<Z7::Z7Index> queue;
+    for (const auto &seed: seeds) {
+        if (inside(seed) && steps.emplace(seed.index, 0).second)
+            queue.push(seed);
+    }
+    while (!queue.empty()) {
+        const Z7::Z7Index cell = queue.front();
+        queue.pop();
+        for (const auto &neighbor: Z7::neighbors(cell, Z7::igeo7)) {
+            if (neighbor != Z7::Z7Index::invalid() && inside(neighbor) &&
+                steps.emplace(neighbor.index, steps[cell.index] + 1).second)
+                queue.push(neighbor);
+        }
+    }
+    std::vector<std::vector<Z7::Z7Index>> res;
+    for (const auto &[index, step]: steps) {
+        res.resize(std::max(res.size(), step + 1));
+        res[step].push_back(Z7::Z7Index{index});
+    }
+    return res;
+}
+
+// Every cell but those with a 3 after the first digit, which leaves holes and narrow passages.
+bool WithoutThrees(const Z7::Z7Index &cell) {
+    for (int r = 2; r <= cell.resolution(); r++) {
+        if (cell[r] == 3)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+TEST(FloodFill, Small) {
+    const auto steps = Z7::flood_fill({"0812"_Z7}, [](const Z7::Z7Index &) { return true; }, Z7::igeo7);
+    ASSERT_GT(steps.size(), 2);
+    EXPECT_EQ(std::vector<Z7::Z7Index>{"0812"_Z7}, steps[0]);
+    auto around = Z7::neighbors("0812"_Z7, Z7::igeo7);
+    std::sort(around.begin(), around.end(), Z7::detail::index_less);
+    EXPECT_EQ(std::vector<Z7::Z7Index>(around.begin(), around.end()), steps[1]);
+    size_t total = 0;
+    for (const auto &step: steps)
+        total += step.size();
+    EXPECT_EQ(12 * (49 - 7 - 1), total); // all but the exclusion zones
+
+    // Seeds outside or repeated are skipped.
+    const Z7::Z7CellSet cells({"0812"_Z7, "0813"_Z7, "0850"_Z7});
+    const auto in_set = Z7::flood_fill({"0812"_Z7, "0812"_Z7, "0820"_Z7}, cells, Z7::igeo7);
+    EXPECT_EQ((std::vector<std::vector<Z7::Z7Index>>{{"0812"_Z7}, {"0813"_Z7}}), in_set);
+    EXPECT_TRUE(Z7::flood_fill({}, cells, Z7::igeo7).empty());
+}
+
+TEST(FloodFill, MatchesQueue) {
+    for (int resolution: {3, 6}) {
+        const std::vector<Z7::Z7Index> seeds{Z7::from_ordinal(1, resolution), Z7::from_ordinal(12345, resolution)};
+        const auto expected = FloodByQueue(seeds, WithoutThrees);
+        EXPECT_EQ(expected, Z7::flood_fill(seeds, WithoutThrees, Z7::igeo7, 1));
+        EXPECT_EQ(expected, Z7::flood_fill(seeds, WithoutThrees, Z7::igeo7, 4));
+    }
+}
+
+TEST(FloodFill, FineResolutions) {
+    // The visited bits only take memory around the seeds, even where the resolution has 10^17 cells.
+    for (int resolution: {16, 20}) {
+        const std::vector<Z7::Z7Index> seeds{Z7::center_child("0812"_Z7, resolution),
+                                             Z7::center_child("1054"_Z7, resolution)};
+        const auto inside = [&](const Z7::Z7Index &cell) {
+            return std::any_of(seeds.begin(), seeds.end(), [&](const Z7::Z7Index &seed) {
+                return Z7::is_descendant_of(cell, Z7::parent(seed, resolution - 3));
+            });
+        };
+        const auto steps = Z7::flood_fill(seeds, inside, Z7::igeo7, 4);
+        EXPECT_EQ(FloodByQueue(seeds, inside), steps);
+        size_t total = 0;
+        for (const auto &step: steps)
+            total += step.size();
+        EXPECT_EQ(2 * 343, total);
+    }
+}
+
+TEST(FloodFill, ConnectedComponents) {
+    // Two patches of zone 8 and one of zone 9, apart.
+    std::vector<Z7::Z7Index> cells;
+    for (const auto &parent: {"0812"_Z7, "0850"_Z7, "0943"_Z7}) {
+        for (uint64_t digit = 0; digit < 7; digit++) {
+            Z7::Z7Index child = Z7::center_child(parent, 3);
+            child[3] = digit;
+            cells.push_back(child);
+        }
+    }
+    const Z7::Z7CellSet set(cells);
+    const auto labels = Z7::connected_components(set, Z7::igeo7);
+    ASSERT_EQ(set.size(), labels.size());
+    EXPECT_EQ(std::vector<uint32_t>(7, 0), std::vector<uint32_t>(labels.begin(), labels.begin() + 7));
+    EXPECT_EQ(std::vector<uint32_t>(7, 1), std::vector<uint32_t>(labels.begin() + 7, labels.begin() + 14));
+    EXPECT_EQ(std::vector<uint32_t>(7, 2), std::vector<uint32_t>(labels.begin() + 14, labels.end()));
+
+    EXPECT_TRUE(Z7::connected_components(Z7::Z7CellSet(), Z7::igeo7).empty());
+
+    // Each component is what a flood from its first cell reaches.
+    std::vector<Z7::Z7Index> mask;
+    for (uint64_t o = 0; o < Z7::ordinal_count(4); o++) {
+        const Z7::Z7Index cell = Z7::from_ordinal(o, 4);
+        if (WithoutThrees(cell) && o % 5 != 0 &&
+            !Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base]))
+            mask.push_back(cell);
+    }
+    const Z7::Z7CellSet masked(mask);
+    const auto components = Z7::connected_components(masked, Z7::igeo7, 4);
+    std::map<uint32_t, std::vector<Z7::Z7Index>> members;
+    for (size_t i = 0; i < masked.size(); i++)
+        members[components[i]].push_back(masked.data()[i]);
+    EXPECT_GT(members.size(), 1);
+    for (const auto &[label, component]: members) {
+        std::vector<Z7::Z7Index> reached;
+        for (const auto &step: Z7::flood_fill({component.front()}, masked, Z7::igeo7))
+            reached.insert(reached.end(), step.begin(), step.end());
+        std::sort(reached.begin(), reached.end(), Z7::detail::index_less);
+        ASSERT_EQ(component, reached) << label;
+    }
+}
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../geo.h"
+
+namespace {
+// Random positions uniform on the sphere.
+std::vector<std::pair<double, double>> RandomPositions(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> z(-1, 1), lon(-180, 180);
+    std::vector<std::pair<double, double>> res;
+    for (size_t i = 0; i < count; i++)
+        res.emplace_back(std::asin(z(rng)) * 180 / Z7::detail::pi, lon(rng));
+    return res;
+}
+} // namespace
+
+TEST(Z7Geo, Vertices) {
+    // The pole of the icosahedron is base cell 0, the opposite vertex base cell 1.
+    EXPECT_EQ(Z7::from_geo(58.282525588538994675, 11.25, 0), "00"_Z7);
+    EXPECT_EQ(Z7::from_geo(58.282525588538994675, 11.25, 6), "00000000"_Z7);
+    EXPECT_EQ(Z7::from_geo(-58.282525588538994675, -168.75, 0), "11"_Z7);
+    EXPECT_EQ(Z7::from_geo(-58.282525588538994675, -168.75, 9), "11000000000"_Z7);
+}
+
+TEST(Z7Geo, NearbyPositions) {
+    // Positions close to each other are in the same or neighbor cells.
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> jitter(-1, 1);
+    for (int resolution: {1, 2, 5, 10, 15, 20}) {
+        const double step = 0.3 * std::pow(7, -resolution / 2.0);
+        for (const auto &[lat, lon]: RandomPositions(20000, resolution)) {
+            const Z7::Z7Index a = Z7::from_geo(lat, lon, resolution);
+            const Z7::Z7Index b = Z7::from_geo(lat + step * jitter(rng), lon + step * jitter(rng), resolution);
+            ASSERT_EQ(a.resolution(), resolution);
+            if (a == b)
+                continue;
+            const auto n = Z7::neighbors(a);
+            EXPECT_NE(std::find(n.begin(), n.end(), b), n.end()) << a.str() << " " << b.str() << " at " << lat << " " << lon;
+        }
+    }
+}
+
+TEST(Z7Geo, Coverage) {
+    // Every cell at resolution 2 has positions, and none outside of the valid cells.
+    std::set<uint64_t> cells;
+    for (const auto &[lat, lon]: RandomPositions(200000, 3))
+        cells.insert(Z7::from_geo(lat, lon, 2).index);
+    EXPECT_EQ(cells.size(), 10 * 49 + 2);
+    for (const auto index: cells) {
+        const Z7::Z7Index cell{index};
+        EXPECT_FALSE(Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base])) << cell.str();
+    }
+}
+
+TEST(Z7Geo, Batch) {
+    const auto positions = RandomPositions(1000, 4);
+    std::vector<double> lat, lon;
+    for (const auto &[a, b]: positions) {
+        lat.push_back(a);
+        lon.push_back(b);
+    }
+    std::vector<Z7::Z7Index> out(positions.size());
+    Z7::from_geo(lat.data(), lon.data(), positions.size(), 12, out.data());
+    for (size_t i = 0; i < positions.size(); i++)
+        EXPECT_EQ(out[i], Z7::from_geo(lat[i], lon[i], 12)) << i;
+}
+
+namespace {
+// Random existing cells at a resolution.
+std::vector<Z7::Z7Index> RandomCells(size_t count, int resolution, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Z7::Z7Index> res;
+    while (res.size() < count) {
+        const Z7::Z7Index cell = Z7::from_ordinal(rng() % Z7::ordinal_count(resolution), resolution);
+        if (!Z7::detail::in_exclusion_zone(cell, Z7::igeo7.exclusion_zone[cell.hierarchy.base]))
+            res.push_back(cell);
+    }
+    return res;
+}
+
+double Distance(const Z7::Z7GeoPoint &a, const Z7::Z7GeoPoint &b) {
+    const auto pa = Z7::detail::unit_vector(a.lat, a.lon), pb = Z7::detail::unit_vector(b.lat, b.lon);
+    const Z7::detail::Vec3 chord{pa.x - pb.x, pa.y - pb.y, pa.z - pb.z};
+    return 2 * std::asin(std::sqrt(Z7::detail::dot(chord, chord)) / 2) * 180 / Z7::detail::pi;
+}
+} // namespace
+
+TEST(Z7Geo, ToGeo) {
+    // The center of a cell is in the cell.
+    for (int resolution = 0; resolution <= 20; resolution++) {
+        for (const auto &cell: RandomCells(2000, resolution, resolution)) {
+            const Z7::Z7GeoPoint p = Z7::to_geo(cell);
+            EXPECT_EQ(Z7::from_geo(p.lat, p.lon, resolution), cell) << cell.str();
+        }
+    }
+    const Z7::Z7GeoPoint pole = Z7::to_geo("00"_Z7);
+    EXPECT_NEAR(pole.lat, 58.282525588538994675, 1e-9);
+    EXPECT_NEAR(pole.lon, 11.25, 1e-9);
+}
+
+TEST(Z7Geo, Boundary) {
+    for (int resolution: {0, 1, 2, 5, 12}) {
+        for (const auto &cell: RandomCells(500, resolution, resolution)) {
+            const Z7::Z7Boundary b = Z7::boundary(cell);
+            const bool pentagon = resolution == 0 || Z7::first_non_zero(cell) > static_cast<size_t>(resolution);
+            EXPECT_EQ(b.count, pentagon ? 5 : 6) << cell.str();
+            // Points between the center and the vertices are in the cell, and every vertex is one of a neighbor.
+            const Z7::Z7GeoPoint center = Z7::to_geo(cell);
+            const auto c = Z7::detail::unit_vector(center.lat, center.lon);
+            for (size_t k = 0; k < b.count; k++) {
+                const auto v = Z7::detail::unit_vector(b.vertices[k].lat, b.vertices[k].lon);
+                const auto inside = Z7::detail::normalized({c.x + 9 * v.x, c.y + 9 * v.y, c.z + 9 * v.z});
+                EXPECT_EQ(Z7::from_geo(std::asin(inside.z) * 180 / Z7::detail::pi,
+                                       std::atan2(inside.y, inside.x) * 180 / Z7::detail::pi, resolution),
+                          cell)
+                    << cell.str() << " " << k;
+                double closest = 180;
+                for (const auto &neighbor: Z7::neighbors(cell)) {
+                    if (neighbor == Z7::Z7Index::invalid())
+                        continue;
+                    const Z7::Z7Boundary nb = Z7::boundary(neighbor);
+                    for (size_t j = 0; j < nb.count; j++)
+                        closest = std::min(closest, Distance(b.vertices[k], nb.vertices[j]));
+                }
+                EXPECT_LT(closest, 1e-9) << cell.str() << " " << k;
+            }
+        }
+    }
+}
+
+TEST(Z7Geo, CentroidCache) {
+    const Z7::Z7CentroidCache cache(4);
+    EXPECT_EQ(cache.max_resolution(), 4);
+    for (int resolution = 0; resolution <= 6; resolution++) {
+        const auto cells = RandomCells(1000, resolution, resolution);
+        std::vector<double> lat(cells.size()), lon(cells.size());
+        cache.to_geo(cells.data(), cells.size(), lat.data(), lon.data());
+        for (size_t i = 0; i < cells.size(); i++) {
+            const Z7::Z7GeoPoint p = Z7::to_geo(cells[i]);
+            EXPECT_EQ(lat[i], p.lat);
+            EXPECT_EQ(lon[i], p.lon);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+#include "../grid.h"
+
+namespace {
+// Distances from a cell to every cell of its resolution, by ordinal, walking from neighbor to neighbor.
+std::vector<int64_t> BreadthFirst(const Z7::Z7Index &source) {
+    const int resolution = source.resolution();
+    std::vector<int64_t> res(Z7::ordinal_count(resolution), -1);
+    std::queue<Z7::Z7Index> queue;
+    res[Z7::ordinal(source)] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+        const Z7::Z7Index cell = queue.front();
+        queue.pop();
+        for (const auto &neighbor: Z7::neighbors(cell, Z7::igeo7)) {
+            if (neighbor == Z7::Z7Index::invalid() || res[Z7::ordinal(neighbor)] >= 0)
+                continue;
+            res[Z7::ordinal(neighbor)] = res[Z7::ordinal(cell)] + 1;
+            queue.push(neighbor);
+        }
+    }
+    return res;
+}
+
+void CheckAgainstBreadthFirst(int resolution, uint64_t source_step, uint64_t target_step) {
+    const uint64_t count = Z7::ordinal_count(resolution);
+    for (uint64_t s = 0; s < count; s += source_step) {
+        const Z7::Z7Index source = Z7::from_ordinal(s, resolution);
+        if (Z7::detail::in_exclusion_zone(source, Z7::igeo7.exclusion_zone[source.hierarchy.base]))
+            continue;
+        const std::vector<int64_t> expected = BreadthFirst(source);
+        for (uint64_t t = s % target_step; t < count; t += target_step) {
+            if (expected[t] < 0)
+                continue;
+            const Z7::Z7Index target = Z7::from_ordinal(t, resolution);
+            ASSERT_EQ(Z7::grid_distance(source, target), expected[t]) << source.str() << " " << target.str();
+        }
+    }
+}
+
+void CheckPath(const Z7::Z7Index &a, const Z7::Z7Index &b) {
+    std::vector<Z7::Z7Index> path;
+    Z7::grid_path(a, b, path);
+    ASSERT_EQ(static_cast<int64_t>(path.size()), Z7::grid_distance(a, b) + 1) << a.str() << " " << b.str();
+    EXPECT_EQ(path.front(), a);
+    EXPECT_EQ(path.back(), b);
+    for (size_t i = 1; i < path.size(); i++) {
+        const auto around = Z7::neighbors(path[i - 1], Z7::igeo7);
+        ASSERT_NE(std::find(around.begin(), around.end(), path[i]), around.end())
+            << a.str() << " " << b.str() << " at " << i;
+    }
+}
+} // namespace
+
+TEST(Z7Grid, Simple) {
+    EXPECT_EQ(Z7::grid_distance("08"_Z7, "08"_Z7), 0);
+    EXPECT_EQ(Z7::grid_distance("081"_Z7, "080"_Z7), 1);
+    EXPECT_EQ(Z7::grid_distance("081"_Z7, "08"_Z7), -1);
+    for (const auto &neighbor: Z7::neighbors("0812"_Z7, Z7::igeo7))
+        EXPECT_EQ(Z7::grid_distance("0812"_Z7, neighbor), 1) << neighbor.str();
+    // Around a pentagon, and across zones.
+    for (const auto &neighbor: Z7::neighbors("00"_Z7, Z7::igeo7)) {
+        if (neighbor != Z7::Z7Index::invalid()) {
+            EXPECT_EQ(Z7::grid_distance("00"_Z7, neighbor), 1) << neighbor.str();
+        }
+    }
+    EXPECT_EQ(Z7::grid_distance("00"_Z7, "11"_Z7), 3);
+}
+
+TEST(Z7Grid, Configuration) {
+    const Z7::Z7Configuration config = Z7::igeo7;
+    EXPECT_EQ(Z7::grid_distance("00"_Z7, "11"_Z7, config), 3);
+    EXPECT_EQ(Z7::grid_distance("0812"_Z7, "0345"_Z7, config), Z7::grid_distance("0812"_Z7, "0345"_Z7));
+    std::vector<Z7::Z7Index> expected, path;
+    Z7::grid_path("0812"_Z7, "0345"_Z7, expected);
+    Z7::grid_path("0812"_Z7, "0345"_Z7, path, config);
+    EXPECT_EQ(expected, path);
+}
+
+TEST(Z7Grid, BreadthFirst) {
+    CheckAgainstBreadthFirst(1, 1, 1);
+    CheckAgainstBreadthFirst(2, 1, 1);
+    CheckAgainstBreadthFirst(3, 29, 1);
+    CheckAgainstBreadthFirst(5, 20011, 7);
+}
+
+TEST(Z7Grid, Path) {
+    for (int resolution: {1, 2, 4, 9}) {
+        const uint64_t count = Z7::ordinal_count(resolution);
+        for (uint64_t i = 0; i < 400; i++) {
+            const Z7::Z7Index a = Z7::from_ordinal(i * 7919 % count, resolution);
+            const Z7::Z7Index b = Z7::from_ordinal((i * 104729 + 13) % count, resolution);
+            if (Z7::detail::in_exclusion_zone(a, Z7::igeo7.exclusion_zone[a.hierarchy.base]) ||
+                Z7::detail::in_exclusion_zone(b, Z7::igeo7.exclusion_zone[b.hierarchy.base]))
+                continue;
+            CheckPath(a, b);
+        }
+    }
+    std::vector<Z7::Z7Index> path;
+    Z7::grid_path("081"_Z7, "08"_Z7, path);
+    EXPECT_TRUE(path.empty());
+}
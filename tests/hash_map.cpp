@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../hash_map.h"
+
+TEST(HashMap, Basic) {
+    Z7::Z7HashMap<int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.insert("0812"_Z7, 1).second);
+    EXPECT_FALSE(map.insert("0812"_Z7, 2).second);
+    EXPECT_EQ(1, *map.find("0812"_Z7));
+    EXPECT_EQ(nullptr, map.find("0813"_Z7));
+    map["0813"_Z7] += 5;
+    EXPECT_EQ(5, *map.find("0813"_Z7));
+    EXPECT_EQ(2, map.size());
+    EXPECT_TRUE(map.erase("0812"_Z7));
+    EXPECT_FALSE(map.erase("0812"_Z7));
+    EXPECT_FALSE(map.contains("0812"_Z7));
+    EXPECT_EQ(1, map.size());
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains("0813"_Z7));
+}
+
+TEST(HashMap, MatchesUnorderedMap) {
+    std::mt19937_64 generator(29);
+    Z7::Z7HashMap<uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> expected;
+    // Keys from a small range of consecutive cells, so there are many repeats and erases of present keys.
+    Z7::Z7Index first{"0823456012345601234"};
+    std::vector<Z7::Z7Index> cells;
+    for (int i = 0; i < 3000; i++)
+        cells.push_back(first++);
+    for (int i = 0; i < 200000; i++) {
+        const auto &key = cells[generator() % cells.size()];
+        const uint64_t value = generator();
+        switch (generator() % 3) {
+            case 0:
+                EXPECT_EQ(expected.emplace(key.index, value).second, map.insert(key, value).second);
+                break;
+            case 1:
+                EXPECT_EQ(expected.erase(key.index) == 1, map.erase(key));
+                break;
+            default:
+                const auto it = expected.find(key.index);
+                const auto found = map.find(key);
+                ASSERT_EQ(it == expected.end(), found == nullptr);
+                if (found != nullptr) {
+                    EXPECT_EQ(it->second, *found);
+                }
+        }
+        ASSERT_EQ(expected.size(), map.size());
+    }
+    size_t visited = 0;
+    map.for_each([&](const Z7::Z7Index &key, uint64_t value) {
+        EXPECT_EQ(expected.at(key.index), value);
+        visited++;
+    });
+    EXPECT_EQ(expected.size(), visited);
+}
+
+TEST(HashMap, BulkInsert) {
+    std::vector<Z7::Z7Index> keys;
+    std::vector<int> values;
+    Z7::Z7Index cell{"0800000000"};
+    for (int i = 0; i < 100000; i++) {
+        keys.push_back(cell++);
+        values.push_back(i);
+    }
+    Z7::Z7HashMap<int> map(10);
+    map.insert(keys.data(), values.data(), keys.size());
+    EXPECT_EQ(keys.size(), map.size());
+    EXPECT_GE(map.capacity() * 7 / 8, keys.size());
+    for (int i = 0; i < 100000; i += 997)
+        EXPECT_EQ(i, *map.find(keys[i]));
+}
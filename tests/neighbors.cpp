@@ -4057,3 +4057,66 @@ TEST(Neighbors, Level3) {
     }
     EXPECT_EQ(failures, 0) << "There were " << failures << " failures in " << testCount << " tests.";
 }
+
+TEST(Neighbors, Batch) {
+    auto defaultConfig = Z7::Z7Configuration{};
+
+    std::vector<Z7::Z7Index> cells;
+    auto testData = GetParsedTestData(neighborTestDataLevel3, std::size(neighborTestDataLevel3));
+    for (auto &[cellIndex, expected_neighbors]: testData) {
+        cells.push_back(cellIndex);
+    }
+    // Finer cells, some of them close to the base zone centers.
+    std::mt19937_64 generator(7);
+    for (int i = 0; i < 1000; i++) {
+        Z7::Z7Index cell = Z7::Z7Index::invalid();
+        cell.hierarchy.base = generator() % 12;
+        const int resolution = 1 + generator() % 20;
+        const int zeros = generator() % (resolution + 1);
+        for (int r = 1; r <= resolution; r++) {
+            cell[r] = r <= zeros ? 0 : generator() % 7;
+        }
+        cells.push_back(cell);
+    }
+
+    std::vector<std::array<Z7::Z7Index, 6>> batch(cells.size());
+    Z7::neighbors_batch(cells.data(), cells.size(), batch.data(), defaultConfig);
+    for (size_t i = 0; i < cells.size(); i++) {
+        const auto neighbors = Z7::neighbors(cells[i], defaultConfig);
+        EXPECT_EQ(JoinIndexes(neighbors).str(), JoinIndexes(batch[i]).str()) << "Cell: " << cells[i].str();
+    }
+}
+
+namespace {
+// A configuration only known at compile time, to specialize neighbors<Config>() on.
+constexpr Z7::Z7Configuration compileTimeConfig{};
+
+// Whether the neighbors of a cell are the given words, in a constant expression.
+constexpr bool NeighborWords(uint64_t cell, const std::array<uint64_t, 6> &expected) {
+    const auto neighbors = Z7::neighbors<Z7::igeo7>(Z7::Z7Index{cell});
+    for (size_t i = 0; i < 6; i++) {
+        if (neighbors[i].index != expected[i])
+            return false;
+    }
+    return true;
+}
+
+// The cells are given by their words, as the text constructor can not be constant evaluated: 08246 next to zone 06,
+// 0051 in a polar zone next to zone 01, and the pentagon 0800.
+static_assert(NeighborWords(0x8537ffffffffffff, {0x8507ffffffffffff, 0x85afffffffffffff, 0x8517ffffffffffff,
+                                                 0x8ccfffffffffffff, 0x8527ffffffffffff, 0x8cdfffffffffffff}));
+static_assert(NeighborWords(0x0a7fffffffffffff, {0x16ffffffffffffff, 0x0affffffffffffff, 0x033fffffffffffff,
+                                                 0x0b7fffffffffffff, 0x16bfffffffffffff, 0x0a3fffffffffffff}));
+static_assert(NeighborWords(0x803fffffffffffff, {0x807fffffffffffff, 0x80bfffffffffffff, 0x80ffffffffffffff,
+                                                 0x813fffffffffffff, 0xffffffffffffffff, 0x81bfffffffffffff}));
+} // namespace
+
+TEST(Neighbors, CompileTimeConfiguration) {
+    auto testData = GetParsedTestData(neighborTestDataLevel3, std::size(neighborTestDataLevel3));
+
+    for (auto &[cellIndex, expected_neighbors]: testData) {
+        const auto neighbors = Z7::neighbors(cellIndex, Z7::Z7Configuration{});
+        EXPECT_EQ(JoinIndexes(neighbors).str(), JoinIndexes(Z7::neighbors(cellIndex)).str());
+        EXPECT_EQ(JoinIndexes(neighbors).str(), JoinIndexes(Z7::neighbors<compileTimeConfig>(cellIndex)).str());
+    }
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "../axial.h"
+#include "../grid.h"
+#include "../ray.h"
+
+TEST(Z7Ray, Simple) {
+    // Along digit 1 from the center of zone 8, in its frame.
+    Z7::Z7RayIterator ray("08000000"_Z7, 1);
+    for (int64_t i = 0; i < 20; i++, ++ray) {
+        EXPECT_EQ(Z7::to_axial(*ray, 0), (Z7::Z7Axial{i, 0})) << ray->str();
+        EXPECT_EQ(1, ray.direction());
+    }
+    // From a pentagon center towards its exclusion zone: the next direction in turning order.
+    const uint8_t exclusion = Z7::igeo7.exclusion_zone[8];
+    Z7::Z7RayIterator pentagon("0800"_Z7, exclusion);
+    ++pentagon;
+    EXPECT_EQ(Z7::neighbors("0800"_Z7, Z7::igeo7)[exclusion * 3 % 7 - 1], *pentagon);
+}
+
+TEST(Z7Ray, MatchesNeighbors) {
+    for (int resolution: {1, 4, 7}) {
+        const uint64_t count = Z7::ordinal_count(resolution);
+        for (uint64_t o = 0; o < count; o += count / 200 + 1) {
+            const Z7::Z7Index start = Z7::from_ordinal(o, resolution);
+            if (Z7::detail::in_exclusion_zone(start, Z7::igeo7.exclusion_zone[start.hierarchy.base]))
+                continue;
+            for (uint8_t direction = 1; direction < 7; direction++) {
+                Z7::Z7RayIterator ray(start, direction);
+                // The run of steps in one zone and direction so far, from its first cell.
+                Z7::Z7Index run_start = start;
+                int64_t run = 0;
+                for (int i = 0; i < 100; i++) {
+                    const Z7::Z7Index cell = *ray;
+                    const uint8_t step = ray.direction();
+                    ++ray;
+                    const auto around = Z7::neighbors(cell, Z7::igeo7);
+                    ASSERT_NE(std::find(around.begin(), around.end(), *ray), around.end())
+                        << start.str() << " " << cell.str() << " " << ray->str();
+                    if (step != ray.direction() || cell.hierarchy.base != ray->hierarchy.base) {
+                        run_start = *ray;
+                        run = 0;
+                        continue;
+                    }
+                    // Straight: the same step in the frame of the zone every time, and as far as it went.
+                    EXPECT_EQ(around[step - 1], *ray) << cell.str();
+                    const Z7::Z7Axial from = Z7::to_axial(cell, 0), to = Z7::to_axial(*ray, 0);
+                    const Z7::Z7Axial expected = {Z7::detail::digit_steps[step].a, Z7::detail::digit_steps[step].b};
+                    ASSERT_EQ(expected, (Z7::Z7Axial{to.q - from.q, to.r - from.r}))
+                        << cell.str() << " " << ray->str();
+                    run++;
+                    if (resolution < 7) {
+                        ASSERT_EQ(run, Z7::grid_distance(run_start, *ray)) << run_start.str() << " " << ray->str();
+                    }
+                }
+            }
+        }
+    }
+}
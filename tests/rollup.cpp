@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: © 2025 Javier Jimenez Shaw <https://github.com/jjimenezshaw>
+// SPDX-FileCopyrightText: © 2025 Weston James Renoud <https://github.com/wrenoud>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../rollup.h"
+
+namespace {
+// Rollup with a std::map per resolution.
+std::vector<Z7::Z7Values<int64_t>> RollupByMap(const Z7::Z7Values<int64_t> &cells, int resolution, Z7::Z7Aggregate op) {
+    std::vector<Z7::Z7Values<int64_t>> res;
+    for (int r = 0; r <= resolution; r++) {
+        std::map<uint64_t, int64_t> groups;
+        for (const auto &[cell, value]: cells) {
+            const uint64_t key = Z7::parent(cell, r).index;
+            const int64_t v = op == Z7::Z7Aggregate::count ? 1 : value;
+            const auto [it, inserted] = groups.emplace(key, v);
+            if (!inserted)
+                it->second = op == Z7::Z7Aggregate::min   ? std::min(it->second, v)
+                             : op == Z7::Z7Aggregate::max ? std::max(it->second, v)
+                                                          : it->second + v;
+        }
+        res.emplace_back();
+        for (const auto &[key, value]: groups)
+            res.back().emplace_back(Z7::Z7Index{key}, value);
+    }
+    return res;
+}
+} // namespace
+
+TEST(Rollup, Small) {
+    const Z7::Z7Values<int> cells{{"08120"_Z7, 1}, {"08121"_Z7, 2}, {"08121"_Z7, 3}, {"08130"_Z7, 4}, {"09000"_Z7, 5}};
+    const auto sums = Z7::rollup(cells.data(), cells.size(), Z7::Z7Aggregate::sum);
+    ASSERT_EQ(4, sums.size());
+    EXPECT_EQ(Z7::Z7Values<int>({{"08"_Z7, 10}, {"09"_Z7, 5}}), sums[0]);
+    EXPECT_EQ(Z7::Z7Values<int>({{"0812"_Z7, 6}, {"0813"_Z7, 4}, {"0900"_Z7, 5}}), sums[2]);
+    EXPECT_EQ(Z7::Z7Values<int>({{"08120"_Z7, 1}, {"08121"_Z7, 5}, {"08130"_Z7, 4}, {"09000"_Z7, 5}}), sums[3]);
+    EXPECT_EQ(Z7::Z7Values<int>({{"08"_Z7, 4}, {"09"_Z7, 1}}),
+              Z7::rollup(cells.data(), cells.size(), Z7::Z7Aggregate::count)[0]);
+    EXPECT_TRUE(Z7::rollup(cells.data(), 0, Z7::Z7Aggregate::sum).empty());
+}
+
+TEST(Rollup, MatchesMaps) {
+    std::mt19937_64 generator(31);
+    const int resolution = 6;
+    Z7::Z7Values<int64_t> cells;
+    for (int i = 0; i < 300000; i++) {
+        Z7::Z7Index cell{(generator() % 3 + 7) << 60 | GBT::Addition::SWAR::digits_mask};
+        for (int r = 1; r <= resolution; r++)
+            cell[r] = generator() % 7;
+        cells.emplace_back(cell, static_cast<int64_t>(generator() % 1000) - 500);
+    }
+    std::sort(cells.begin(), cells.end(), [](const auto &a, const auto &b) { return a.first.index < b.first.index; });
+    for (const auto op: {Z7::Z7Aggregate::sum, Z7::Z7Aggregate::min, Z7::Z7Aggregate::max, Z7::Z7Aggregate::count}) {
+        const auto expected = RollupByMap(cells, resolution, op);
+        EXPECT_EQ(expected, Z7::rollup(cells.data(), cells.size(), op, 1));
+        EXPECT_EQ(expected, Z7::rollup(cells.data(), cells.size(), op, 3));
+    }
+}
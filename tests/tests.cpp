@@ -3,6 +3,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <set>
+#include <vector>
+
 #include "../library.h"
 
 namespace Z7 {
@@ -161,6 +165,36 @@ TEST(Z7Index, addition_with_carries) {
     }
 }
 
+TEST(Z7Index, addition_mixed_resolution) {
+    EXPECT_EQ("080153"_Z7, "080153"_Z7 + "0800"_Z7);
+    EXPECT_EQ("080153"_Z7, "0800"_Z7 + "080153"_Z7);
+    EXPECT_EQ("080433"_Z7, "080430"_Z7 + "08"_Z7 + "080003"_Z7);
+    EXPECT_EQ("08"_Z7, "08"_Z7 + "08"_Z7);
+    EXPECT_EQ("15"_Z7, "08"_Z7 + "09"_Z7); // invalid
+}
+
+TEST(Z7Index, rotate) {
+    EXPECT_EQ("0812345"_Z7, Z7::rotate("0812345"_Z7, 0));
+    EXPECT_EQ("0853164"_Z7, Z7::rotate("0812345"_Z7, 1)); // multiply by 5
+    EXPECT_EQ("0841526"_Z7, Z7::rotate("0812345"_Z7, 2));
+    EXPECT_EQ("0865432"_Z7, Z7::rotate("0812345"_Z7, 3)); // negation
+    EXPECT_EQ("0824613"_Z7, Z7::rotate("0812345"_Z7, 4));
+    EXPECT_EQ("0836251"_Z7, Z7::rotate("0812345"_Z7, 5)); // multiply by 3
+    EXPECT_EQ("0812345"_Z7, Z7::rotate("0812345"_Z7, 6));
+    EXPECT_EQ("0800500"_Z7, Z7::rotate("0800100"_Z7, 1));
+    EXPECT_EQ("08"_Z7, Z7::rotate("08"_Z7, 3));
+    EXPECT_EQ(-"0806420153"_Z7, Z7::rotate("0806420153"_Z7, 3));
+
+    const auto a = "0506420153412356010253"_Z7;
+    auto b = a;
+    for (int k = 0; k < 12; k++) {
+        EXPECT_EQ(b, Z7::rotate(a, k)) << k;
+        for (int i = 1; i <= 20; i++) {
+            b[i] = (*b[i] * 5) % 7;
+        }
+    }
+}
+
 TEST(Z7Index, first_non_zero) {
     EXPECT_EQ(6, Z7::first_non_zero("0000000"_Z7));
     EXPECT_EQ(6, Z7::first_non_zero("1000000"_Z7));
@@ -290,3 +324,357 @@ TEST(Z7Index, center20) {
     EXPECT_EQ(21, Z7::first_non_zero(a));
     EXPECT_EQ(20, Z7::first_non_zero(neig[5]));
 }
+
+namespace {
+// Cells within k steps of ref by breadth first search over neighbors(), one set per distance.
+std::vector<std::set<uint64_t>> RingsByBFS(const Z7::Z7Index &ref, int k) {
+    std::vector<std::set<uint64_t>> rings{{ref.index}};
+    std::set<uint64_t> seen{ref.index};
+    for (int r = 1; r <= k; r++) {
+        std::set<uint64_t> ring;
+        for (const auto cell: rings.back()) {
+            for (const auto &n: Z7::neighbors(Z7::Z7Index{cell}, Z7::igeo7)) {
+                if (n != Z7::Z7Index::invalid() && seen.insert(n.index).second)
+                    ring.insert(n.index);
+            }
+        }
+        rings.push_back(ring);
+    }
+    return rings;
+}
+} // namespace
+
+TEST(Z7Index, grid_disk_size) {
+    EXPECT_EQ(1, Z7::grid_disk_size(0));
+    EXPECT_EQ(7, Z7::grid_disk_size(1));
+    EXPECT_EQ(19, Z7::grid_disk_size(2));
+    EXPECT_EQ(331, Z7::grid_disk_size(10));
+    EXPECT_EQ(1, Z7::grid_ring_size(0));
+    EXPECT_EQ(60, Z7::grid_ring_size(10));
+}
+
+TEST(Z7Index, grid_disk_neighbors) {
+    const auto a = "0800432"_Z7;
+    std::array<Z7::Z7Index, 7> disk;
+    EXPECT_EQ(7, Z7::grid_disk(a, 1, disk.data(), Z7::igeo7));
+    EXPECT_EQ(a, disk[0]);
+    const auto neig = Z7::neighbors(a, Z7::igeo7);
+    for (const auto &n: neig) {
+        EXPECT_NE(disk.end(), std::find(disk.begin() + 1, disk.end(), n)) << n.str();
+    }
+}
+
+TEST(Z7Index, grid_disk_pentagon) {
+    std::array<Z7::Z7Index, 7> disk;
+    EXPECT_EQ(6, Z7::grid_disk("0800"_Z7, 1, disk.data(), Z7::igeo7));
+    EXPECT_EQ("0800"_Z7, disk[0]);
+    EXPECT_EQ(Z7::Z7Index::invalid(), disk[6]);
+
+    std::array<Z7::Z7Index, 6> ring;
+    EXPECT_EQ(5, Z7::grid_ring("0800"_Z7, 1, ring.data(), Z7::igeo7));
+    EXPECT_EQ(Z7::Z7Index::invalid(), ring[5]);
+
+    // Nothing for a negative k.
+    EXPECT_EQ(0, Z7::grid_disk_size(-1));
+    EXPECT_EQ(0, Z7::grid_ring_size(-1));
+    ring.fill("0812"_Z7);
+    EXPECT_EQ(0, Z7::grid_disk("0800"_Z7, -1, ring.data(), Z7::igeo7));
+    EXPECT_EQ(0, Z7::grid_ring("0800"_Z7, -2, ring.data(), Z7::igeo7));
+    EXPECT_EQ("0812"_Z7, ring[0]);
+}
+
+TEST(Z7Index, grid_disk_matches_bfs) {
+    std::mt19937_64 generator(3);
+    for (int test = 0; test < 500; test++) {
+        Z7::Z7Index cell = Z7::Z7Index::invalid();
+        cell.hierarchy.base = generator() % 12;
+        const int resolution = 1 + generator() % 8;
+        for (int r = 1; r <= resolution; r++) {
+            cell[r] = generator() % 7;
+        }
+        if (Z7::first_non_zero(cell) <= static_cast<size_t>(resolution) &&
+            *cell[Z7::first_non_zero(cell)] == Z7::igeo7.exclusion_zone[cell.hierarchy.base])
+            continue; // not a valid cell
+        const int k = 1 + generator() % 6;
+
+        const auto expected = RingsByBFS(cell, k);
+        std::vector<Z7::Z7Index> disk(Z7::grid_disk_size(k));
+        const auto count = Z7::grid_disk(cell, k, disk.data(), Z7::igeo7);
+        size_t expected_count = 0;
+        for (int r = 0; r <= k; r++) {
+            std::set<uint64_t> ring;
+            for (size_t i = expected_count; i < std::min(count, expected_count + expected[r].size()); i++)
+                ring.insert(disk[i].index);
+            EXPECT_EQ(expected[r], ring) << "Cell: " << cell.str() << " k: " << k << " ring: " << r;
+            expected_count += expected[r].size();
+        }
+        EXPECT_EQ(expected_count, count) << "Cell: " << cell.str() << " k: " << k;
+
+        std::vector<Z7::Z7Index> ring(Z7::grid_ring_size(k));
+        const auto ring_count = Z7::grid_ring(cell, k, ring.data(), Z7::igeo7);
+        std::set<uint64_t> ring_indexes;
+        for (size_t i = 0; i < ring_count; i++)
+            ring_indexes.insert(ring[i].index);
+        EXPECT_EQ(expected[k], ring_indexes) << "Cell: " << cell.str() << " k: " << k;
+    }
+}
+
+TEST(Z7Index, parent) {
+    const auto a = "0812345"_Z7;
+    EXPECT_EQ("08123"_Z7, Z7::parent(a, 3));
+    EXPECT_EQ("08"_Z7, Z7::parent(a, 0));
+    EXPECT_EQ(a, Z7::parent(a, 5));
+    EXPECT_EQ(a, Z7::parent(a, 20));
+    static_assert(Z7::parent(Z7::Z7Index{uint64_t{0}}, 19) == Z7::Z7Index{uint64_t{0b111}});
+}
+
+TEST(Z7Index, center_child) {
+    EXPECT_EQ("081230000"_Z7, Z7::center_child("08123"_Z7, 7));
+    EXPECT_EQ("0800000000000000000000"_Z7, Z7::center_child("08"_Z7, 20));
+    EXPECT_EQ("08123"_Z7, Z7::center_child("08123"_Z7, 3));
+}
+
+TEST(Z7Index, children) {
+    const auto a = "08123"_Z7;
+    const auto c = Z7::children(a);
+    for (int d = 0; d < 7; d++) {
+        EXPECT_EQ(4, c[d].resolution());
+        EXPECT_EQ(d, c[d][4]);
+        EXPECT_EQ(a, Z7::parent(c[d], 3));
+    }
+    EXPECT_EQ("081230"_Z7, c[0]);
+    EXPECT_EQ("081236"_Z7, c[6]);
+    for (const auto &child: Z7::children("0812345601234560123456"_Z7))
+        EXPECT_EQ(Z7::Z7Index::invalid(), child);
+}
+
+TEST(Z7Index, is_descendant_of) {
+    EXPECT_TRUE(Z7::is_descendant_of("0812345"_Z7, "0812"_Z7));
+    EXPECT_TRUE(Z7::is_descendant_of("0812345"_Z7, "08"_Z7));
+    EXPECT_TRUE(Z7::is_descendant_of("0812"_Z7, "0812"_Z7));
+    EXPECT_FALSE(Z7::is_descendant_of("0812"_Z7, "0812345"_Z7));
+    EXPECT_FALSE(Z7::is_descendant_of("0813345"_Z7, "0812"_Z7));
+    EXPECT_FALSE(Z7::is_descendant_of("0912345"_Z7, "0812"_Z7));
+}
+
+TEST(Z7Index, descendant_range) {
+    const auto a = "08123"_Z7;
+    const auto range = Z7::descendant_range(a, 6);
+    EXPECT_EQ("08123000"_Z7.index, range.first);
+    EXPECT_EQ("08123666"_Z7.index, range.last);
+    EXPECT_TRUE(Z7::contains(range, "08123456"_Z7));
+    EXPECT_FALSE(Z7::contains(range, "08124000"_Z7));
+    EXPECT_FALSE(Z7::contains(range, "08122666"_Z7));
+
+    const auto self = Z7::descendant_range(a, 3);
+    EXPECT_EQ(a.index, self.first);
+    EXPECT_EQ(a.index, self.last);
+
+    // Two binary searches over sorted cells find the same descendants as checking every cell.
+    std::mt19937_64 generator(7);
+    std::vector<uint64_t> cells;
+    for (int i = 0; i < 20000; i++) {
+        auto cell = "08123"_Z7;
+        for (int r = 4; r <= 7; r++)
+            cell[r] = generator() % 7;
+        cells.push_back(cell.index);
+    }
+    std::sort(cells.begin(), cells.end());
+    for (const auto &parent: {"0812"_Z7, "081234"_Z7, "0812340"_Z7, "08123"_Z7}) {
+        const auto r = Z7::descendant_range(parent, 7);
+        const auto found = std::upper_bound(cells.begin(), cells.end(), r.last) -
+                           std::lower_bound(cells.begin(), cells.end(), r.first);
+        const auto expected = std::count_if(cells.begin(), cells.end(), [&](uint64_t c) {
+            return Z7::is_descendant_of(Z7::Z7Index{c}, parent);
+        });
+        EXPECT_EQ(expected, found);
+    }
+}
+
+TEST(Z7Index, ordinal) {
+    EXPECT_EQ(8, Z7::ordinal("08"_Z7));
+    EXPECT_EQ(8 * 49 + 1 * 7 + 2, Z7::ordinal("0812"_Z7));
+    EXPECT_EQ(Z7::ordinal_count(20) - 1, Z7::ordinal("1166666666666666666666"_Z7));
+    EXPECT_EQ("0812"_Z7, Z7::from_ordinal(8 * 49 + 1 * 7 + 2, 2));
+    EXPECT_EQ("11"_Z7, Z7::from_ordinal(11, 0));
+
+    // Dense and in the order of the indexes.
+    for (int resolution = 0; resolution <= 4; resolution++) {
+        Z7::Z7Index previous = Z7::from_ordinal(0, resolution);
+        EXPECT_EQ(0, Z7::ordinal(previous));
+        for (uint64_t i = 1; i < Z7::ordinal_count(resolution); i++) {
+            const auto cell = Z7::from_ordinal(i, resolution);
+            EXPECT_EQ(resolution, cell.resolution());
+            EXPECT_LT(previous.index, cell.index);
+            ASSERT_EQ(i, Z7::ordinal(cell));
+            previous = cell;
+        }
+    }
+
+    std::mt19937_64 generator(9);
+    for (int i = 0; i < 10000; i++) {
+        const int resolution = static_cast<int>(generator() % 21);
+        const uint64_t n = generator() % Z7::ordinal_count(resolution);
+        ASSERT_EQ(n, Z7::ordinal(Z7::from_ordinal(n, resolution)));
+    }
+}
+
+TEST(Z7Index, increment) {
+    EXPECT_EQ("08124"_Z7, ++"08123"_Z7);
+    EXPECT_EQ("08130"_Z7, ++"08126"_Z7);
+    EXPECT_EQ("08200"_Z7, ++"08166"_Z7);
+    EXPECT_EQ(Z7::Z7Index::invalid(), ++"08"_Z7);
+    // Past the last cell of the zone the first digit is 7.
+    auto last = "0866"_Z7;
+    last[1] = 7;
+    last[2] = 0;
+    EXPECT_EQ(last, ++"0866"_Z7);
+    // And then the end.
+    auto past = "0866"_Z7;
+    ++past;
+    EXPECT_EQ(Z7::Z7Index::invalid(), ++past);
+    size_t steps = 0;
+    for (auto cell = "0860"_Z7; cell != Z7::Z7Index::invalid(); ++cell)
+        ASSERT_LT(++steps, 10u);
+    EXPECT_EQ(8u, steps);
+
+    // Same as adding one to the last digit and carrying, one digit at a time.
+    std::mt19937_64 generator(11);
+    for (int i = 0; i < 100000; i++) {
+        Z7::Z7Index cell{(generator() % 12) << 60 | GBT::Addition::SWAR::digits_mask};
+        const int resolution = static_cast<int>(generator() % 20) + 1;
+        for (int r = 1; r <= resolution; r++)
+            cell[r] = generator() % 3 == 0 ? generator() % 7 : 6;
+        Z7::Z7Index expected = cell;
+        for (int r = resolution; r > 0; r--) {
+            const uint64_t digit = *expected[r] + 1;
+            expected[r] = digit == 7 && r > 1 ? 0 : digit;
+            if (digit < 7 || r == 1)
+                break;
+        }
+        ASSERT_EQ(expected, ++cell);
+    }
+}
+
+TEST(Z7Range, Descendants) {
+    const Z7::Z7Range range("0812"_Z7, 4);
+    EXPECT_EQ(49, range.size());
+    std::vector<Z7::Z7Index> cells(range.begin(), range.end());
+    ASSERT_EQ(49, cells.size());
+    EXPECT_EQ("081200"_Z7, cells.front());
+    EXPECT_EQ("081266"_Z7, cells.back());
+    EXPECT_TRUE(std::is_sorted(cells.begin(), cells.end(), Z7::detail::index_less));
+    for (const auto &cell: cells)
+        EXPECT_TRUE(Z7::is_descendant_of(cell, "0812"_Z7));
+
+    // Parts cover the range in order, also the last ones of a base zone.
+    for (const auto &ancestor: {"0812"_Z7, "0866"_Z7, "11"_Z7}) {
+        const Z7::Z7Range all(ancestor, 5);
+        std::vector<Z7::Z7Index> expected(all.begin(), all.end());
+        std::vector<Z7::Z7Index> parts;
+        for (size_t part = 0; part < 5; part++) {
+            const Z7::Z7Range some = all.split(part, 5);
+            parts.insert(parts.end(), some.begin(), some.end());
+        }
+        EXPECT_EQ(expected, parts);
+        EXPECT_EQ(all.size(), expected.size());
+    }
+
+    const Z7::Z7Range empty("0812"_Z7, 4, 3, 3);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+    const Z7::Z7Range itself("0812"_Z7, 2);
+    EXPECT_EQ(std::vector<Z7::Z7Index>{"0812"_Z7}, std::vector<Z7::Z7Index>(itself.begin(), itself.end()));
+}
+
+TEST(Z7Index, to_chars) {
+    char text[Z7::max_chars];
+    const auto a = "0812345"_Z7;
+    EXPECT_EQ("0812345", std::string(text, Z7::to_chars(text, text + Z7::max_chars, a)));
+    EXPECT_EQ("11", std::string(text, Z7::to_chars(text, text + 2, "11"_Z7)));
+    EXPECT_EQ(nullptr, Z7::to_chars(text, text + 6, a));
+
+    std::mt19937_64 generator(5);
+    std::vector<Z7::Z7Index> cells;
+    std::string expected;
+    for (int i = 0; i < 1000; i++) {
+        Z7::Z7Index cell{(generator() % 12) << 60 | GBT::Addition::SWAR::digits_mask};
+        const int resolution = static_cast<int>(generator() % 21);
+        // The text built digit by digit, as str() is to_chars() too.
+        std::string digits{static_cast<char>('0' + cell.hierarchy.base / 10),
+                           static_cast<char>('0' + cell.hierarchy.base % 10)};
+        for (int r = 1; r <= resolution; r++) {
+            cell[r] = generator() % 7;
+            digits += static_cast<char>('0' + *cell[r]);
+        }
+        ASSERT_EQ(digits, std::string(text, Z7::to_chars(text, text + Z7::max_chars, cell)));
+        cells.push_back(cell);
+        expected += digits + "\n";
+    }
+    std::vector<char> out((Z7::max_chars + 1) * cells.size());
+    char *end = Z7::to_chars(out.data(), out.data() + out.size(), cells.data(), cells.size());
+    EXPECT_EQ(expected, std::string(out.data(), end));
+    EXPECT_EQ(end, Z7::to_chars(out.data(), out.data() + expected.size(), cells.data(), cells.size()));
+    EXPECT_EQ(nullptr, Z7::to_chars(out.data(), out.data() + expected.size() - 1, cells.data(), cells.size()));
+}
+
+TEST(Z7Index, from_chars) {
+    const auto parse = [](const std::string &text, Z7::Z7Index &value) {
+        return Z7::from_chars(text.data(), text.data() + text.size(), value);
+    };
+    Z7::Z7Index value;
+    EXPECT_EQ(std::errc(), parse("0812345", value).ec);
+    EXPECT_EQ("0812345"_Z7, value);
+    EXPECT_EQ(std::errc(), parse("11", value).ec);
+    EXPECT_EQ("11"_Z7, value);
+    EXPECT_EQ(std::errc(), parse("0823456012345601234560", value).ec);
+    EXPECT_EQ("0823456012345601234560"_Z7, value);
+
+    const std::string text = "0812345,";
+    const auto result = Z7::from_chars(text.data(), text.data() + text.size(), value);
+    EXPECT_EQ(text.data() + 7, result.ptr);
+
+    value = "0812345"_Z7;
+    EXPECT_EQ(std::errc::invalid_argument, parse("", value).ec);
+    EXPECT_EQ(std::errc::invalid_argument, parse("8", value).ec);
+    EXPECT_EQ(std::errc::invalid_argument, parse("12", value).ec);
+    EXPECT_EQ(std::errc::invalid_argument, parse("0x12", value).ec);
+    EXPECT_EQ(std::errc::invalid_argument, parse("081237", value).ec);
+    EXPECT_EQ(std::errc::invalid_argument, parse("0812345601234569", value).ec);
+    EXPECT_EQ(std::errc::result_out_of_range, parse("08123456012345601234560", value).ec);
+    EXPECT_EQ(std::errc::result_out_of_range, parse("0812345601234560123456012345601", value).ec);
+    EXPECT_EQ("0812345"_Z7, value);
+
+    std::mt19937_64 generator(11);
+    for (int i = 0; i < 1000; i++) {
+        Z7::Z7Index cell{(generator() % 12) << 60 | GBT::Addition::SWAR::digits_mask};
+        const int resolution = static_cast<int>(generator() % 21);
+        for (int r = 1; r <= resolution; r++)
+            cell[r] = generator() % 7;
+        ASSERT_EQ(std::errc(), parse(cell.str(), value).ec);
+        ASSERT_EQ(cell, value);
+    }
+}
+
+TEST(Z7Index, from_chars_batch) {
+    const std::string text = "0812345\n11,0000\r\n0823456012345601234560\n";
+    std::array<Z7::Z7Index, 5> cells;
+    auto result = Z7::from_chars(text.data(), text.data() + text.size(), cells.data(), cells.size());
+    EXPECT_EQ(std::errc(), result.ec);
+    EXPECT_EQ(text.data() + text.size(), result.ptr);
+    ASSERT_EQ(4, result.count);
+    EXPECT_EQ("0812345"_Z7, cells[0]);
+    EXPECT_EQ("11"_Z7, cells[1]);
+    EXPECT_EQ("0000"_Z7, cells[2]);
+    EXPECT_EQ("0823456012345601234560"_Z7, cells[3]);
+
+    result = Z7::from_chars(text.data(), text.data() + text.size(), cells.data(), 2);
+    EXPECT_EQ(2, result.count);
+    EXPECT_EQ(text.data() + 11, result.ptr);
+
+    const std::string bad = "0812345\n0812395\n";
+    result = Z7::from_chars(bad.data(), bad.data() + bad.size(), cells.data(), cells.size());
+    EXPECT_EQ(std::errc::invalid_argument, result.ec);
+    EXPECT_EQ(1, result.count);
+    EXPECT_EQ(bad.data() + 8, result.ptr);
+}
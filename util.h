@@ -6,10 +6,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #if __cplusplus >= 202002L
 #include <bit>
-#elif defined(_MSC_VER)
+#endif
+#if defined(_MSC_VER)
 #include <intrin.h>
+#include <stdlib.h>
 #endif
 
 namespace Z7::Utils {
@@ -71,6 +74,19 @@ constexpr size_t countr_one(uint64_t x) {
     return countr_zero(~x);
 }
 
+// Read 8 bytes as a big endian word, so the first one ends up in the top byte.
+inline uint64_t load_big_endian(const char *p) {
+    uint64_t x = 0;
+    std::memcpy(&x, p, sizeof(x));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return x;
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
 } // namespace Z7::Utils
 
 #endif // Z7_UTIL_H